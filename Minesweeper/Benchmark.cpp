@@ -0,0 +1,700 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Benchmark.h"
+#include "MineMap.h"
+#include "SparseMineMap.h"
+#include "ThreadPool.h"
+
+namespace Minesweeper::Benchmarks
+{
+    using Minesweeper::MineMap::EventType;
+    using Minesweeper::MineMap::GameStatus;
+    using Minesweeper::MineMap::GridStatus;
+    using Minesweeper::MineMap::Position;
+
+    /// <summary>
+    /// A board of the benchmark corpus.
+    /// </summary>
+    struct BoardSpec
+    {
+        /// <summary>
+        /// The name of the board.
+        /// </summary>
+        std::string name;
+
+        /// <summary>
+        /// The width of the map.
+        /// </summary>
+        int width;
+
+        /// <summary>
+        /// The height of the map.
+        /// </summary>
+        int height;
+
+        /// <summary>
+        /// The count of mines.
+        /// </summary>
+        int mineCount;
+
+        /// <summary>
+        /// The seed of the layouts, the scripts and the solver guesses.
+        /// </summary>
+        unsigned seed;
+
+        /// <summary>
+        /// The number of games played by the solver.
+        /// </summary>
+        int solverGames;
+
+        /// <summary>
+        /// The recorded number of games won by the solver.
+        /// </summary>
+        int expectedSolved;
+
+        /// <summary>
+        /// The number of games replaying a random move script.
+        /// </summary>
+        int scriptGames;
+
+        /// <summary>
+        /// The number of moves in each script.
+        /// </summary>
+        int scriptMoves;
+
+        /// <summary>
+        /// The recorded number of scripts which win.
+        /// </summary>
+        int expectedScriptWins;
+
+        /// <summary>
+        /// The recorded total number of grids open at the end of the scripts.
+        /// </summary>
+        int expectedScriptOpenGrids;
+
+        /// <summary>
+        /// The minimum number of games per second of engine time when no other is given.
+        /// Set well below what a release build makes on one core, so that only real regressions fail.
+        /// </summary>
+        double minGamesPerSecond;
+    };
+
+    /// <summary>
+    /// The move types of a script.
+    /// </summary>
+    enum MoveType
+    {
+        /// <summary>
+        /// Clicks a grid.
+        /// </summary>
+        click,
+
+        /// <summary>
+        /// Chords a grid.
+        /// </summary>
+        chord,
+
+        /// <summary>
+        /// Flags a grid.
+        /// </summary>
+        flag,
+    };
+
+    /// <summary>
+    /// The result of a game, compared across the engines.
+    /// </summary>
+    struct GameResult
+    {
+        /// <summary>
+        /// Whether the player wins.
+        /// </summary>
+        bool isWinning;
+
+        /// <summary>
+        /// The number of moves made.
+        /// </summary>
+        int moves;
+
+        /// <summary>
+        /// The final grid statuses.
+        /// </summary>
+        std::vector<std::vector<GridStatus>> gridStatus;
+
+        /// <summary>
+        /// Compares two results.
+        /// </summary>
+        bool operator==(const GameResult&) const = default;
+    };
+
+    /// <summary>
+    /// The benchmark corpus. The huge board is too large for the solver and only replays scripts.
+    /// </summary>
+    const std::vector<BoardSpec> CORPUS = {
+        { "beginner", 9, 9, 10, 1, 200, 185, 50, 40, 0, 2593, 1000.0 },
+        { "intermediate", 16, 16, 40, 2, 100, 75, 20, 80, 0, 1678, 250.0 },
+        { "expert", 16, 30, 99, 3, 200, 26, 10, 150, 0, 687, 150.0 },
+        { "huge", 1000, 1000, 5000, 4, 0, 0, 2, 20, 0, 1989641, 0.0 },
+    };
+
+    /// <summary>
+    /// The board of the flood fill scaling test. With so few mines, the first click opens almost the whole map.
+    /// </summary>
+    const BoardSpec SCALING_BOARD = { "flood fill", 3000, 3000, 9000, 5, 0, 0, 0, 0, 0, 0, 0.0 };
+
+    /// <summary>
+    /// Picks the mines of a layout. The result only depends on the random engine, not on the standard library.
+    /// </summary>
+    /// <param name="spec">The board.</param>
+    /// <param name="random">The random engine.</param>
+    /// <param name="start">The position of the first click. It and its adjacent grids will not have mine, so that the first click opens an area.</param>
+    /// <returns>The positions of the mines.</returns>
+    std::vector<Position> generate_layout(const BoardSpec& spec, std::mt19937& random, const Position start)
+    {
+        auto positions = std::vector<Position>();
+        for (auto x = 0; x < spec.width; x++)
+        {
+            for (auto y = 0; y < spec.height; y++)
+            {
+                if (std::abs(x - start.first) > 1 || std::abs(y - start.second) > 1)
+                {
+                    positions.push_back(Position(x, y));
+                }
+            }
+        }
+
+        // Partial Fisher-Yates shuffle.
+        const auto count = positions.size();
+        for (auto i = 0; i < spec.mineCount; i++)
+        {
+            std::swap(positions[i], positions[i + random() % (count - i)]);
+        }
+
+        positions.resize(spec.mineCount);
+        return positions;
+    }
+
+    /// <summary>
+    /// Generates a random move script starting with a click on the start position.
+    /// </summary>
+    /// <param name="spec">The board.</param>
+    /// <param name="random">The random engine.</param>
+    /// <param name="start">The position of the first click.</param>
+    /// <returns>The moves.</returns>
+    std::vector<std::pair<MoveType, Position>> generate_script(const BoardSpec& spec, std::mt19937& random, const Position start)
+    {
+        auto script = std::vector<std::pair<MoveType, Position>>{ { click, start } };
+
+        for (auto i = 1; i < spec.scriptMoves; i++)
+        {
+            const auto type = static_cast<MoveType>(random() % 3);
+            const auto x = static_cast<int>(random() % spec.width);
+            const auto y = static_cast<int>(random() % spec.height);
+            script.push_back({ type, Position(x, y) });
+        }
+
+        return script;
+    }
+
+    /// <summary>
+    /// Finds the moves given by a pair of nearby hints: if every closed grid around one hint is also around the other,
+    /// the other closed grids around the second hint hold exactly the difference of their remaining mines.
+    /// </summary>
+    /// <param name="spec">The board.</param>
+    /// <param name="gridStatus">The grid statuses.</param>
+    /// <param name="values">The values of the open grids.</param>
+    /// <returns>The moves of the first pair giving any, or no moves.</returns>
+    std::vector<std::pair<MoveType, Position>> find_pair_moves(const BoardSpec& spec, const std::vector<std::vector<GridStatus>>& gridStatus, const std::vector<std::vector<int>>& values)
+    {
+        // Gets the closed grids around an open hint, and the number of mines among them.
+        auto get_closed_grids = [&](const int x, const int y) {
+            auto remainingMines = values[x][y];
+            auto closedGrids = std::set<Position>();
+            for (auto i = std::max(x - 1, 0); i <= std::min(x + 1, spec.width - 1); i++)
+            {
+                for (auto j = std::max(y - 1, 0); j <= std::min(y + 1, spec.height - 1); j++)
+                {
+                    if (gridStatus[i][j] == GridStatus::flagged)
+                    {
+                        remainingMines--;
+                    }
+                    else if (gridStatus[i][j] == GridStatus::closed)
+                    {
+                        closedGrids.insert(Position(i, j));
+                    }
+                }
+            }
+
+            return std::pair(remainingMines, closedGrids);
+        };
+
+        for (auto x = 0; x < spec.width; x++)
+        {
+            for (auto y = 0; y < spec.height; y++)
+            {
+                if (gridStatus[x][y] != GridStatus::open)
+                {
+                    continue;
+                }
+
+                const auto [mines, closedGrids] = get_closed_grids(x, y);
+                if (closedGrids.empty())
+                {
+                    continue;
+                }
+
+                // Only hints up to two grids away can share closed grids.
+                for (auto i = std::max(x - 2, 0); i <= std::min(x + 2, spec.width - 1); i++)
+                {
+                    for (auto j = std::max(y - 2, 0); j <= std::min(y + 2, spec.height - 1); j++)
+                    {
+                        if ((i == x && j == y) || gridStatus[i][j] != GridStatus::open)
+                        {
+                            continue;
+                        }
+
+                        const auto [otherMines, otherClosedGrids] = get_closed_grids(i, j);
+                        if (otherClosedGrids.size() <= closedGrids.size() || !std::ranges::includes(otherClosedGrids, closedGrids))
+                        {
+                            continue;
+                        }
+
+                        const auto extraMines = otherMines - mines;
+                        const auto extraGridCount = static_cast<int>(otherClosedGrids.size() - closedGrids.size());
+                        if (extraMines != 0 && extraMines != extraGridCount)
+                        {
+                            continue;
+                        }
+
+                        // No extra mines means the extra grids are safe, and as many mines as grids means they are all mines.
+                        auto moves = std::vector<std::pair<MoveType, Position>>();
+                        for (const auto& pos : otherClosedGrids)
+                        {
+                            if (!closedGrids.contains(pos))
+                            {
+                                moves.push_back({ extraMines == 0 ? click : flag, pos });
+                            }
+                        }
+
+                        return moves;
+                    }
+                }
+            }
+        }
+
+        return {};
+    }
+
+    /// <summary>
+    /// Plays a game with a simple solver: flags the closed grids around a hint that must all be mines,
+    /// chords the hints that have enough flags, compares pairs of nearby hints when no single one helps,
+    /// and clicks a random closed grid when stuck.
+    /// The solver keeps its own copy of the board up to date from the events of the game,
+    /// and only checks the hints around the grids which changed. Only the moves are timed, not the solver.
+    /// Each round decides on every changed hint from the same board, then makes all the flags and then all the chords.
+    /// The flags are always right, so no chord of a round depends on another, and a batch plays the same game as single moves.
+    /// </summary>
+    /// <param name="game">The game.</param>
+    /// <param name="spec">The board.</param>
+    /// <param name="random">The random engine for the guesses.</param>
+    /// <param name="start">The position of the first click.</param>
+    /// <param name="isBatch">Whether to make the flags and the chords of a round with one call each, if the engine supports it.</param>
+    /// <param name="engineSeconds">Increased by the time spent in the engine.</param>
+    /// <returns>The result of the game.</returns>
+    template <typename Engine>
+    GameResult solve(Engine game, const BoardSpec& spec, std::mt19937 random, const Position start, const bool isBatch, double& engineSeconds)
+    {
+        auto gridStatus = std::vector<std::vector<GridStatus>>(spec.width, std::vector<GridStatus>(spec.height, GridStatus::closed));
+        auto values = std::vector<std::vector<int>>(spec.width, std::vector<int>(spec.height, 0));
+
+        // The open grids whose hints may allow a move. Sorted, so that every engine gets the same moves whatever the order of its events.
+        auto pendingGrids = std::set<Position>();
+
+        game.set_event_sink([&](const auto& event) {
+            if (event.type == EventType::game_over)
+            {
+                return;
+            }
+
+            const auto x = static_cast<int>(event.pos.first);
+            const auto y = static_cast<int>(event.pos.second);
+
+            if (event.type == EventType::grid_opened)
+            {
+                gridStatus[x][y] = GridStatus::open;
+                values[x][y] = event.value;
+            }
+            else
+            {
+                gridStatus[x][y] = event.status;
+            }
+
+            // The change may allow a move from this grid or the hints around it.
+            for (auto i = std::max(x - 1, 0); i <= std::min(x + 1, spec.width - 1); i++)
+            {
+                for (auto j = std::max(y - 1, 0); j <= std::min(y + 1, spec.height - 1); j++)
+                {
+                    if (gridStatus[i][j] == GridStatus::open && values[i][j] != Minesweeper::MineMap::MineMap::EMPTY)
+                    {
+                        pendingGrids.insert(Position(i, j));
+                    }
+                }
+            }
+            });
+
+        auto moves = 0;
+
+        // Makes a move, only timing the engine.
+        auto play = [&](const MoveType type, const Position pos) {
+            const auto startTime = std::chrono::steady_clock::now();
+            switch (type)
+            {
+            case click:
+                game.click(pos);
+                break;
+            case chord:
+                game.chord(pos);
+                break;
+            case flag:
+                game.flag(pos);
+                break;
+            }
+            engineSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            moves++;
+        };
+
+        // Makes chords or flags, with one call in batch mode. Each position counts as a move either way.
+        auto play_all = [&](const MoveType type, const std::vector<Position>& positions) {
+            if constexpr (requires { game.chord_all(positions); game.flag_all(positions); })
+            {
+                if (isBatch)
+                {
+                    const auto startTime = std::chrono::steady_clock::now();
+                    if (type == chord)
+                    {
+                        game.chord_all(positions);
+                    }
+                    else
+                    {
+                        game.flag_all(positions);
+                    }
+                    engineSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+                    moves += static_cast<int>(positions.size());
+                    return;
+                }
+            }
+
+            for (const auto& pos : positions)
+            {
+                play(type, pos);
+            }
+        };
+
+        play(click, start);
+
+        while (game.get_game_status() != GameStatus::over)
+        {
+            if (pendingGrids.empty())
+            {
+                const auto pairMoves = find_pair_moves(spec, gridStatus, values);
+                for (const auto& [type, pos] : pairMoves)
+                {
+                    play(type, pos);
+                }
+
+                if (!pairMoves.empty())
+                {
+                    continue;
+                }
+
+                auto closedGrids = std::vector<Position>();
+                for (auto x = 0; x < spec.width; x++)
+                {
+                    for (auto y = 0; y < spec.height; y++)
+                    {
+                        if (gridStatus[x][y] == GridStatus::closed)
+                        {
+                            closedGrids.push_back(Position(x, y));
+                        }
+                    }
+                }
+
+                play(click, closedGrids[random() % closedGrids.size()]);
+                continue;
+            }
+
+            auto flags = std::set<Position>();
+            auto chords = std::vector<Position>();
+
+            for (const auto& [x, y] : std::exchange(pendingGrids, {}))
+            {
+                auto flagCount = 0;
+                auto adjacentClosedGrids = std::vector<Position>();
+                for (auto i = std::max(x - 1, 0); i <= std::min(x + 1, spec.width - 1); i++)
+                {
+                    for (auto j = std::max(y - 1, 0); j <= std::min(y + 1, spec.height - 1); j++)
+                    {
+                        if (gridStatus[i][j] == GridStatus::flagged)
+                        {
+                            flagCount++;
+                        }
+                        else if (gridStatus[i][j] == GridStatus::closed)
+                        {
+                            adjacentClosedGrids.push_back(Position(i, j));
+                        }
+                    }
+                }
+
+                if (adjacentClosedGrids.empty())
+                {
+                    continue;
+                }
+
+                if (values[x][y] == flagCount + static_cast<int>(adjacentClosedGrids.size()))
+                {
+                    // All closed grids around are mines.
+                    flags.insert(adjacentClosedGrids.begin(), adjacentClosedGrids.end());
+                }
+                else if (values[x][y] == flagCount)
+                {
+                    // All closed grids around are safe.
+                    chords.push_back(Position(x, y));
+                }
+            }
+
+            play_all(flag, std::vector<Position>(flags.begin(), flags.end()));
+            play_all(chord, chords);
+        }
+
+        return { game.is_winning(), moves, game.get_grid_status() };
+    }
+
+    /// <summary>
+    /// Plays a game by replaying a move script.
+    /// </summary>
+    /// <param name="game">The game.</param>
+    /// <param name="script">The moves.</param>
+    /// <returns>The result of the game.</returns>
+    template <typename Engine>
+    GameResult replay(Engine game, const std::vector<std::pair<MoveType, Position>>& script)
+    {
+        for (const auto& [type, pos] : script)
+        {
+            switch (type)
+            {
+            case click:
+                game.click(pos);
+                break;
+            case chord:
+                game.chord(pos);
+                break;
+            case flag:
+                game.flag(pos);
+                break;
+            }
+        }
+
+        return { game.is_winning(), static_cast<int>(script.size()), game.get_grid_status() };
+    }
+
+    /// <summary>
+    /// Times the first click on the scaling board with the serial flood fill,
+    /// and with the parallel one on 1, 2, 4 and so on threads, up to every thread of the shared thread pool.
+    /// </summary>
+    /// <returns>Whether the parallel flood fill opens the same grids as the serial one on every thread count.</returns>
+    bool run_flood_fill_scaling()
+    {
+        auto random = std::mt19937(SCALING_BOARD.seed);
+        const auto start = Position(SCALING_BOARD.width / 2, SCALING_BOARD.height / 2);
+        const auto mines = generate_layout(SCALING_BOARD, random, start);
+
+        // Opens the map on the given number of threads, or serially for 0, and returns the time taken and the grid statuses.
+        auto fill = [&](const unsigned int threadCount) {
+            auto game = Minesweeper::MineMap::MineMap(SCALING_BOARD.width, SCALING_BOARD.height, mines);
+            game.set_flood_fill_mode(threadCount == 0 ? Minesweeper::MineMap::FloodFillMode::serial : Minesweeper::MineMap::FloodFillMode::parallel);
+            game.set_flood_fill_thread_count(threadCount);
+
+            const auto startTime = std::chrono::steady_clock::now();
+            game.click(start);
+            const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+            return std::pair(seconds, game.get_grid_status());
+        };
+
+        // The first fill only warms up the memory allocator.
+        fill(0);
+
+        auto isPassing = true;
+        const auto [serialSeconds, serialGridStatus] = fill(0);
+
+        std::cout << std::left << std::setw(14) << SCALING_BOARD.name << std::setw(12) << "serial"
+            << std::fixed << std::setprecision(3) << serialSeconds << " s" << std::endl;
+
+        const auto maxThreadCount = Minesweeper::Utils::ThreadPool::get_shared().get_worker_count() + 1;
+        for (auto threadCount = 1u; ; threadCount = std::min(threadCount * 2, maxThreadCount))
+        {
+            const auto [seconds, gridStatus] = fill(threadCount);
+
+            std::cout << std::left << std::setw(14) << SCALING_BOARD.name << std::setw(12) << (std::to_string(threadCount) + (threadCount == 1 ? " thread" : " threads"))
+                << std::fixed << std::setprecision(3) << seconds << " s  speed-up " << std::setprecision(2) << serialSeconds / std::max(seconds, 1e-9) << "  ";
+
+            if (gridStatus != serialGridStatus)
+            {
+                std::cout << "[results differ from serial] ";
+                isPassing = false;
+            }
+
+            std::cout << std::endl;
+
+            if (threadCount == maxThreadCount)
+            {
+                break;
+            }
+        }
+
+        return isPassing;
+    }
+
+    bool run_benchmarks(const std::optional<double> minGamesPerSecond)
+    {
+        auto isPassing = true;
+
+        for (const auto& spec : CORPUS)
+        {
+            auto random = std::mt19937(spec.seed);
+            const auto start = Position(spec.width / 2, spec.height / 2);
+
+            auto layouts = std::vector<std::vector<Position>>();
+            for (auto i = 0; i < spec.solverGames + spec.scriptGames; i++)
+            {
+                layouts.push_back(generate_layout(spec, random, start));
+            }
+
+            auto scripts = std::vector<std::vector<std::pair<MoveType, Position>>>();
+            for (auto i = 0; i < spec.scriptGames; i++)
+            {
+                scripts.push_back(generate_script(spec, random, start));
+            }
+
+            auto referenceResults = std::vector<GameResult>();
+
+            // Plays the corpus of this board on one engine, and compares the results with the first engine.
+            auto run_engine = [&](const std::string& engineName, const auto& make_game, const bool isBatch) {
+                auto results = std::vector<GameResult>();
+                auto solved = 0;
+                auto moves = 0;
+
+                auto seconds = 0.0;
+                for (auto i = 0; i < spec.solverGames; i++)
+                {
+                    results.push_back(solve(make_game(layouts[i]), spec, std::mt19937(spec.seed + i), start, isBatch, seconds));
+                    solved += results.back().isWinning ? 1 : 0;
+                    moves += results.back().moves;
+                }
+
+                auto scriptWins = 0;
+                auto scriptOpenGrids = 0;
+                for (auto i = 0; i < spec.scriptGames; i++)
+                {
+                    results.push_back(replay(make_game(layouts[spec.solverGames + i]), scripts[i]));
+                    scriptWins += results.back().isWinning ? 1 : 0;
+                    for (const auto& column : results.back().gridStatus)
+                    {
+                        scriptOpenGrids += static_cast<int>(std::ranges::count(column, GridStatus::open));
+                    }
+                }
+
+                std::cout << std::left << std::setw(14) << spec.name << std::setw(10) << engineName;
+
+                if (spec.solverGames > 0)
+                {
+                    const auto gamesPerSecond = spec.solverGames / std::max(seconds, 1e-9);
+
+                    std::cout << "solved " << solved << "/" << spec.solverGames
+                        << std::fixed << std::setprecision(1)
+                        << "  mean moves " << static_cast<double>(moves) / spec.solverGames
+                        << "  games/s " << gamesPerSecond << "  ";
+
+                    if (solved != spec.expectedSolved)
+                    {
+                        std::cout << "[solved count differs from recorded " << spec.expectedSolved << "] ";
+                        isPassing = false;
+                    }
+
+                    const auto minimum = minGamesPerSecond.value_or(spec.minGamesPerSecond);
+                    if (minimum > 0 && gamesPerSecond < minimum)
+                    {
+                        std::cout << "[too slow] ";
+                        isPassing = false;
+                    }
+                }
+
+                if (referenceResults.empty())
+                {
+                    referenceResults = results;
+                }
+                else if (results != referenceResults)
+                {
+                    std::cout << "[results differ from dense] ";
+                    isPassing = false;
+                }
+
+                std::cout << spec.scriptGames << " scripts replayed, " << scriptWins << " won, " << scriptOpenGrids << " grids open  ";
+
+                // The scripts catch a change shared by every engine, which comparing the engines cannot.
+                if (scriptWins != spec.expectedScriptWins || scriptOpenGrids != spec.expectedScriptOpenGrids)
+                {
+                    std::cout << "[script results differ from recorded " << spec.expectedScriptWins << " won, " << spec.expectedScriptOpenGrids << " grids open] ";
+                    isPassing = false;
+                }
+
+                std::cout << std::endl;
+            };
+
+            run_engine("dense", [&](const auto& mines) {
+                auto game = Minesweeper::MineMap::MineMap(spec.width, spec.height, mines);
+                game.set_flood_fill_mode(Minesweeper::MineMap::FloodFillMode::serial);
+                return game;
+                }, false);
+            run_engine("batch", [&](const auto& mines) {
+                auto game = Minesweeper::MineMap::MineMap(spec.width, spec.height, mines);
+                game.set_flood_fill_mode(Minesweeper::MineMap::FloodFillMode::serial);
+                return game;
+                }, true);
+            run_engine("parallel", [&](const auto& mines) {
+                auto game = Minesweeper::MineMap::MineMap(spec.width, spec.height, mines);
+                game.set_flood_fill_mode(Minesweeper::MineMap::FloodFillMode::parallel);
+                return game;
+                }, false);
+            run_engine("sparse", [&](const auto& mines) {
+                return Minesweeper::MineMap::SparseMineMap(spec.width, spec.height, mines);
+                }, false);
+            run_engine("wide", [&](const auto& mines) {
+                using WideMineMap = Minesweeper::MineMap::BasicMineMap<std::int64_t, std::int8_t>;
+                return WideMineMap(spec.width, spec.height, std::vector<WideMineMap::Position>(mines.begin(), mines.end()));
+                }, false);
+
+            if (spec.width == 16 && spec.height == 16)
+            {
+                run_engine("fixed", [&](const auto& mines) {
+                    return Minesweeper::MineMap::BasicMineMap<int, std::int8_t, 16, 16>(mines);
+                    }, false);
+            }
+        }
+
+        isPassing = run_flood_fill_scaling() && isPassing;
+
+        std::cout << (isPassing ? "===== BENCHMARK PASSED =====" : "===== BENCHMARK FAILED =====") << std::endl;
+
+        return isPassing;
+    }
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <optional>
+
+namespace Minesweeper::Benchmarks
+{
+    /// <summary>
+    /// Plays the fixed-seed board corpus on every engine and prints the solver statistics,
+    /// then times the parallel flood fill on a growing number of threads.
+    /// </summary>
+    /// <param name="minGamesPerSecond">The minimum number of games per second on every board, 0 to skip the check,
+    /// or none to use the floor recorded for each board.</param>
+    /// <returns>Whether all engines agree, the solver and script results match the recorded ones, the throughput is high enough,
+    /// and the parallel flood fill opens the same grids as the serial one.</returns>
+    bool run_benchmarks(const std::optional<double> minGamesPerSecond);
+}
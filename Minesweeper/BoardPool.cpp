@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "BoardPool.h"
+
+namespace Minesweeper::Services
+{
+    BoardPool::BoardPool(const std::size_t capacity, const std::size_t memoryBudget, const unsigned int workerCount)
+        : m_capacity(capacity), m_memoryBudget(memoryBudget), m_reservedMemory(0), m_requestCount(0), m_isStopping(false)
+    {
+        for (auto i = 0u; i < workerCount; i++)
+        {
+            m_workers.emplace_back(&BoardPool::run_worker, this);
+        }
+    }
+
+    BoardPool::~BoardPool()
+    {
+        {
+            auto lock = std::lock_guard(m_mutex);
+            m_isStopping = true;
+        }
+
+        m_condition.notify_all();
+
+        for (auto& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    Minesweeper::MineMap::MineMap BoardPool::acquire(const std::size_t width, const std::size_t height, const int mineCount)
+    {
+        const auto key = BoardKey(width, height, mineCount);
+
+        {
+            auto lock = std::lock_guard(m_mutex);
+            m_requestCount++;
+
+            const auto shelf = m_shelves.find(key);
+            if (shelf != m_shelves.end())
+            {
+                shelf->second.lastRequest = m_requestCount;
+
+                if (!shelf->second.boards.empty())
+                {
+                    auto board = std::move(shelf->second.boards.front());
+                    shelf->second.boards.pop_front();
+                    m_condition.notify_one();
+
+                    return board;
+                }
+            }
+        }
+
+        // A full shelf of this size does not fit in the memory budget, so let the first click place the mines.
+        if (m_capacity == 0 || estimate_board_size(key) > m_memoryBudget / m_capacity)
+        {
+            return Minesweeper::MineMap::MineMap(width, height, mineCount);
+        }
+
+        // Throws on invalid map sizes before they reach the workers.
+        auto random = std::mt19937(std::random_device()());
+        auto board = generate_board(key, random);
+
+        {
+            auto lock = std::lock_guard(m_mutex);
+            if (!m_shelves.contains(key))
+            {
+                add_shelf(key);
+            }
+        }
+
+        m_condition.notify_one();
+
+        return board;
+    }
+
+    void BoardPool::run_worker()
+    {
+        auto random = std::mt19937(std::random_device()());
+        auto lock = std::unique_lock(m_mutex);
+
+        for (;;)
+        {
+            auto shelf = m_shelves.end();
+            m_condition.wait(lock, [&] {
+                shelf = find_shelf_to_fill();
+                return m_isStopping || shelf != m_shelves.end();
+                });
+
+            if (m_isStopping)
+            {
+                return;
+            }
+
+            // Generate without holding the lock. The shelf may be dropped meanwhile, so find it again afterwards.
+            const auto key = shelf->first;
+            const auto firstRequest = shelf->second.firstRequest;
+            shelf->second.pendingCount++;
+            lock.unlock();
+
+            try
+            {
+                auto board = generate_board(key, random);
+
+                lock.lock();
+                shelf = m_shelves.find(key);
+                if (shelf != m_shelves.end() && shelf->second.firstRequest == firstRequest)
+                {
+                    shelf->second.pendingCount--;
+                    shelf->second.boards.push_back(std::move(board));
+                }
+            }
+            catch (...)
+            {
+                // Out of memory or an invalid map size. Stop pooling this size rather than failing again.
+                if (!lock.owns_lock())
+                {
+                    lock.lock();
+                }
+
+                shelf = m_shelves.find(key);
+                if (shelf != m_shelves.end() && shelf->second.firstRequest == firstRequest)
+                {
+                    remove_shelf(shelf);
+                }
+            }
+        }
+    }
+
+    void BoardPool::add_shelf(const BoardKey& key)
+    {
+        const auto shelfSize = m_capacity * estimate_board_size(key);
+
+        while (!m_shelves.empty() && m_reservedMemory + shelfSize > m_memoryBudget)
+        {
+            remove_shelf(std::ranges::min_element(m_shelves, {}, [](const auto& shelf) { return shelf.second.lastRequest; }));
+        }
+
+        auto& shelf = m_shelves[key];
+        shelf.firstRequest = m_requestCount;
+        shelf.lastRequest = m_requestCount;
+        m_reservedMemory += shelfSize;
+    }
+
+    void BoardPool::remove_shelf(const std::map<BoardKey, Shelf>::iterator shelf)
+    {
+        m_reservedMemory -= m_capacity * estimate_board_size(shelf->first);
+        m_shelves.erase(shelf);
+    }
+
+    std::map<BoardPool::BoardKey, BoardPool::Shelf>::iterator BoardPool::find_shelf_to_fill()
+    {
+        return std::ranges::find_if(m_shelves, [this](const auto& shelf) {
+            return shelf.second.boards.size() + shelf.second.pendingCount < m_capacity;
+            });
+    }
+
+    std::size_t BoardPool::estimate_board_size(const BoardKey& key) noexcept
+    {
+        const auto [width, height, mineCount] = key;
+
+        // A column of grid status and a column of the mine bitmap for every X.
+        const auto columnSize = sizeof(std::vector<Minesweeper::MineMap::GridStatus>) + height * sizeof(Minesweeper::MineMap::GridStatus)
+            + sizeof(std::vector<std::uint64_t>) + (height + 63) / 64 * sizeof(std::uint64_t);
+
+        return sizeof(Minesweeper::MineMap::MineMap) + width * columnSize;
+    }
+
+    Minesweeper::MineMap::MineMap BoardPool::generate_board(const BoardKey& key, std::mt19937& random)
+    {
+        const auto [width, height, mineCount] = key;
+
+        if (mineCount < 0)
+        {
+            throw std::invalid_argument("The mine count is negative.");
+        }
+
+        if (static_cast<std::size_t>(mineCount) > width * height)
+        {
+            throw Minesweeper::MineMap::TooManyMinesException();
+        }
+
+        // Number the grids by X and then Y, and pick the mines by Floyd's algorithm, without building the list of all grids.
+        const auto gridCount = width * height;
+        const auto placedCount = std::min<std::size_t>(mineCount, gridCount - 1);
+        auto isMine = std::vector<bool>(gridCount);
+
+        auto positions = std::vector<Minesweeper::MineMap::Position>();
+        positions.reserve(placedCount);
+
+        for (auto i = gridCount - placedCount; i < gridCount; i++)
+        {
+            auto index = std::uniform_int_distribution<std::size_t>(0, i)(random);
+            if (isMine[index])
+            {
+                index = i;
+            }
+
+            isMine[index] = true;
+            positions.push_back(Minesweeper::MineMap::Position(static_cast<int>(index / height), static_cast<int>(index % height)));
+        }
+
+        return Minesweeper::MineMap::MineMap(width, height, positions);
+    }
+}
@@ -0,0 +1,169 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "MineMap.h"
+
+namespace Minesweeper::Services
+{
+    /// <summary>
+    /// Keeps ready-made boards for the recently requested map sizes, refilled by background worker threads,
+    /// so that a new game does not pay for mine generation.
+    /// The mines of a pooled board are placed before the first click, which moves a mine away if it hits one.
+    /// The ready-made boards stay within a memory budget: map sizes too large for it are not pooled,
+    /// and the least recently requested map sizes are dropped to make room for new ones.
+    /// </summary>
+    class BoardPool
+    {
+    public:
+        /// <summary>
+        /// Initialises a new instance of the <see cref="BoardPool"/> class.
+        /// </summary>
+        /// <param name="capacity">The maximum number of ready-made boards for each map size.</param>
+        /// <param name="memoryBudget">The maximum number of bytes of the ready-made boards of every map size together.</param>
+        /// <param name="workerCount">The number of worker threads.</param>
+        BoardPool(const std::size_t capacity, const std::size_t memoryBudget, const unsigned int workerCount);
+
+        /// <summary>
+        /// Stops the worker threads.
+        /// </summary>
+        ~BoardPool();
+
+        BoardPool(const BoardPool&) = delete;
+        BoardPool& operator=(const BoardPool&) = delete;
+
+        /// <summary>
+        /// Takes a ready-made board. If there is none yet, the board is generated on the calling thread,
+        /// and the workers start keeping boards of this size ready if they fit in the memory budget.
+        /// Boards too large for the memory budget are returned without mines, which are placed on the first click.
+        /// </summary>
+        /// <param name="width">The width of the map.</param>
+        /// <param name="height">The height of the map.</param>
+        /// <param name="mineCount">The count of mines.</param>
+        /// <returns>The board.</returns>
+        Minesweeper::MineMap::MineMap acquire(const std::size_t width, const std::size_t height, const int mineCount);
+    private:
+        /// <summary>
+        /// The map size of a board: width, height and count of mines.
+        /// </summary>
+        using BoardKey = std::tuple<std::size_t, std::size_t, int>;
+
+        /// <summary>
+        /// The ready-made boards of one map size.
+        /// </summary>
+        struct Shelf
+        {
+            /// <summary>
+            /// The boards.
+            /// </summary>
+            std::deque<Minesweeper::MineMap::MineMap> boards;
+
+            /// <summary>
+            /// The number of boards being generated by the workers.
+            /// </summary>
+            std::size_t pendingCount = 0;
+
+            /// <summary>
+            /// The request count of the pool when this shelf was added, which tells it from a dropped shelf of the same map size.
+            /// </summary>
+            std::size_t firstRequest = 0;
+
+            /// <summary>
+            /// The request count of the pool when this map size was last requested.
+            /// </summary>
+            std::size_t lastRequest = 0;
+        };
+
+        /// <summary>
+        /// The ready-made boards of every requested map size.
+        /// </summary>
+        std::map<BoardKey, Shelf> m_shelves;
+
+        /// <summary>
+        /// The maximum number of ready-made boards for each map size.
+        /// </summary>
+        std::size_t m_capacity;
+
+        /// <summary>
+        /// The maximum number of bytes of the ready-made boards of every map size together.
+        /// </summary>
+        std::size_t m_memoryBudget;
+
+        /// <summary>
+        /// The number of bytes of full shelves of every map size.
+        /// </summary>
+        std::size_t m_reservedMemory;
+
+        /// <summary>
+        /// The number of boards requested so far, which orders the shelves by their last request.
+        /// </summary>
+        std::size_t m_requestCount;
+
+        /// <summary>
+        /// Whether the worker threads are stopping.
+        /// </summary>
+        bool m_isStopping;
+
+        /// <summary>
+        /// The mutex guarding the shelves.
+        /// </summary>
+        std::mutex m_mutex;
+
+        /// <summary>
+        /// Signals the workers when a board is taken, a map size is added, or the pool is stopping.
+        /// </summary>
+        std::condition_variable m_condition;
+
+        /// <summary>
+        /// The worker threads.
+        /// </summary>
+        std::vector<std::thread> m_workers;
+
+        /// <summary>
+        /// Refills the shelves until the pool is stopping.
+        /// A map size which fails to generate is dropped.
+        /// </summary>
+        void run_worker();
+
+        /// <summary>
+        /// Adds a shelf for a map size, dropping the least recently requested ones until full shelves fit in the memory budget.
+        /// The caller must hold the mutex.
+        /// </summary>
+        /// <param name="key">The map size.</param>
+        void add_shelf(const BoardKey& key);
+
+        /// <summary>
+        /// Drops a shelf with its boards. The caller must hold the mutex.
+        /// </summary>
+        /// <param name="shelf">The shelf.</param>
+        void remove_shelf(const std::map<BoardKey, Shelf>::iterator shelf);
+
+        /// <summary>
+        /// Finds a shelf which is not full, counting the boards being generated.
+        /// </summary>
+        /// <returns>The shelf, or the end of the shelves if all are full.</returns>
+        std::map<BoardKey, Shelf>::iterator find_shelf_to_fill();
+
+        /// <summary>
+        /// Estimates the number of bytes of a board.
+        /// </summary>
+        /// <param name="key">The map size.</param>
+        /// <returns>The number of bytes.</returns>
+        static std::size_t estimate_board_size(const BoardKey& key) noexcept;
+
+        /// <summary>
+        /// Generates a board with randomly placed mines.
+        /// Like the maps which place their mines on the first click, at least one grid is left without a mine.
+        /// </summary>
+        /// <param name="key">The map size.</param>
+        /// <param name="random">The random engine.</param>
+        /// <returns>The board.</returns>
+        static Minesweeper::MineMap::MineMap generate_board(const BoardKey& key, std::mt19937& random);
+    };
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+namespace Minesweeper::MineMap
+{
+    /// <summary>
+    /// The type of a state change event.
+    /// </summary>
+    enum EventType
+    {
+        /// <summary>
+        /// A grid has been opened.
+        /// </summary>
+        grid_opened,
+
+        /// <summary>
+        /// A grid has been flagged or unflagged.
+        /// </summary>
+        flag_toggled,
+
+        /// <summary>
+        /// The game is over.
+        /// </summary>
+        game_over,
+    };
+}
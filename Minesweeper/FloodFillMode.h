@@ -0,0 +1,25 @@
+#pragma once
+
+namespace Minesweeper::MineMap
+{
+    /// <summary>
+    /// The way adjacent grids are opened when an empty grid is clicked.
+    /// </summary>
+    enum FloodFillMode
+    {
+        /// <summary>
+        /// Parallel on large maps, serial otherwise.
+        /// </summary>
+        automatic,
+
+        /// <summary>
+        /// Always on the calling thread.
+        /// </summary>
+        serial,
+
+        /// <summary>
+        /// Always split into tiles filled by the threads of the shared thread pool.
+        /// </summary>
+        parallel,
+    };
+}
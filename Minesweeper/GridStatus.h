@@ -1,11 +1,12 @@
 #pragma once
+#include <cstdint>
 
 namespace Minesweeper::MineMap
 {
     /// <summary>
-    /// The grid status.
+    /// The grid status. Stored in one byte, as there is one for every grid.
     /// </summary>
-    enum GridStatus
+    enum GridStatus : std::uint8_t
     {
         /// <summary>
         /// Closed grid.
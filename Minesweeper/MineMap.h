@@ -1,8 +1,25 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <random>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
+#include "EventType.h"
+#include "FloodFillMode.h"
 #include "GameStatus.h"
 #include "GridStatus.h"
+#include "ThreadPool.h"
 
 namespace Minesweeper::MineMap
 {
@@ -16,35 +33,161 @@ namespace Minesweeper::MineMap
     /// </summary>
     typedef int MineMapValue;
 
+    /// <summary>
+    /// A state change of the game.
+    /// </summary>
+    /// <typeparam name="Coordinate">The type of the coordinates.</typeparam>
+    /// <typeparam name="Cell">The type of the values in the mine map.</typeparam>
+    template <typename Coordinate, typename Cell>
+    struct BasicMineMapEvent
+    {
+        /// <summary>
+        /// The type of the event.
+        /// </summary>
+        EventType type;
+
+        /// <summary>
+        /// The position of the grid. Not used by <see cref="EventType::game_over"/>.
+        /// </summary>
+        std::pair<Coordinate, Coordinate> pos;
+
+        /// <summary>
+        /// The value of the opened grid. Only used by <see cref="EventType::grid_opened"/>.
+        /// </summary>
+        Cell value;
+
+        /// <summary>
+        /// The new status of the grid. Only used by <see cref="EventType::flag_toggled"/>.
+        /// </summary>
+        GridStatus status;
+
+        /// <summary>
+        /// Whether the player wins. Only used by <see cref="EventType::game_over"/>.
+        /// </summary>
+        bool isWinning;
+    };
+
+    /// <summary>
+    /// A state change of the game.
+    /// </summary>
+    using MineMapEvent = BasicMineMapEvent<int, MineMapValue>;
+
+    /// <summary>
+    /// The type of the function receiving state change events.
+    /// </summary>
+    using EventSink = std::function<void(const MineMapEvent&)>;
+
+    /// <summary>
+    /// The storage of one value per grid: nested arrays for a fixed size map, nested vectors otherwise.
+    /// </summary>
+    /// <typeparam name="T">The type of the values.</typeparam>
+    /// <typeparam name="Width">The fixed width, or 0.</typeparam>
+    /// <typeparam name="Height">The fixed height, or 0.</typeparam>
+    template <typename T, std::size_t Width, std::size_t Height>
+    using GridStorage = std::conditional_t<Width != 0 && Height != 0,
+        std::array<std::array<T, Height>, Width>,
+        std::vector<std::vector<T>>>;
+
     /// <summary>
     /// The game state.
     /// </summary>
-    class MineMap
+    /// <typeparam name="Coordinate">The signed integer type of the coordinates.</typeparam>
+    /// <typeparam name="Cell">The integer type of the values in the mine map.</typeparam>
+    /// <typeparam name="Width">The fixed width of the map, or 0 if the width is given at runtime.</typeparam>
+    /// <typeparam name="Height">The fixed height of the map, or 0 if the height is given at runtime.</typeparam>
+    template <typename Coordinate, typename Cell, std::size_t Width = 0, std::size_t Height = 0>
+    class BasicMineMap
     {
+        static_assert(std::is_integral_v<Coordinate> && std::is_signed_v<Coordinate>, "Coordinate must be a signed integer type.");
+        static_assert(std::is_integral_v<Cell>, "Cell must be an integer type.");
+        static_assert((Width == 0) == (Height == 0), "Width and Height must be both fixed or both 0.");
+
     public:
         /// <summary>
-        /// The grid with a mine.
+        /// The position type. The first value is X, and the second is Y.
+        /// </summary>
+        using Position = std::pair<Coordinate, Coordinate>;
+
+        /// <summary>
+        /// The type of the state change events.
+        /// </summary>
+        using Event = BasicMineMapEvent<Coordinate, Cell>;
+
+        /// <summary>
+        /// The type of the function receiving state change events.
         /// </summary>
-        static const MineMapValue MINE = 9;
+        using Sink = std::function<void(const Event&)>;
+
+        /// <summary>
+        /// Whether the map size is fixed at compile time.
+        /// </summary>
+        static constexpr bool IS_FIXED_SIZE = Width != 0;
+
+        /// <summary>
+        /// The value reported for a grid with a mine. Only used in the mine map and the events:
+        /// the mines themselves are kept in a bitmap apart from the hints.
+        /// </summary>
+        static constexpr Cell MINE = 9;
 
         /// <summary>
         /// The grid with no adjacent mines.
         /// </summary>
-        static const MineMapValue EMPTY = 0;
+        static constexpr Cell EMPTY = 0;
+
+        /// <summary>
+        /// The minimum map size for which <see cref="FloodFillMode::automatic"/> fills in parallel.
+        /// </summary>
+        static constexpr std::size_t PARALLEL_FLOOD_FILL_MIN_SIZE = 1 << 20;
+
+        /// <summary>
+        /// Initialises a new instance of the <see cref="BasicMineMap"/> class.
+        /// </summary>
+        /// <param name="width">The width of the map.</param>
+        /// <param name="height">The height of the map.</param>
+        /// <param name="mineCount">The count of mines.</param>
+        BasicMineMap(const std::size_t width, const std::size_t height, const int mineCount) requires (!IS_FIXED_SIZE)
+        {
+            initialise(width, height, mineCount);
+        }
 
         /// <summary>
-        /// Initialises a new instance of the <see cref="MineMap"/> class.
+        /// Initialises a new instance of the <see cref="BasicMineMap"/> class with the given mines.
+        /// If the first click hits a mine, the mine is moved to a random grid without one.
         /// </summary>
         /// <param name="width">The width of the map.</param>
         /// <param name="height">The height of the map.</param>
+        /// <param name="mines">The positions of the mines.</param>
+        BasicMineMap(const std::size_t width, const std::size_t height, const std::vector<Position>& mines) requires (!IS_FIXED_SIZE)
+        {
+            initialise(width, height, static_cast<int>(mines.size()));
+            place_mines(mines);
+        }
+
+        /// <summary>
+        /// Initialises a new instance of the <see cref="BasicMineMap"/> class with the fixed size.
+        /// </summary>
         /// <param name="mineCount">The count of mines.</param>
-        MineMap(const std::size_t width, const std::size_t height, const int mineCount);
+        explicit BasicMineMap(const int mineCount) requires IS_FIXED_SIZE
+        {
+            initialise(Width, Height, mineCount);
+        }
+
+        /// <summary>
+        /// Initialises a new instance of the <see cref="BasicMineMap"/> class with the fixed size and the given mines.
+        /// If the first click hits a mine, the mine is moved to a random grid without one.
+        /// </summary>
+        /// <param name="mines">The positions of the mines.</param>
+        explicit BasicMineMap(const std::vector<Position>& mines) requires IS_FIXED_SIZE
+        {
+            initialise(Width, Height, static_cast<int>(mines.size()));
+            place_mines(mines);
+        }
 
         /// <summary>
         /// Gets mine map.
         /// </summary>
         /// <returns>The mine map.</returns>
-        const std::vector<std::vector<MineMapValue>> get_minemap() const;
+        const std::vector<std::vector<Cell>> get_minemap() const;
 
         /// <summary>
         /// Gets grid statuses.
@@ -64,12 +207,27 @@ namespace Minesweeper::MineMap
         /// <param name="pos">The position where to chord.</param>
         void chord(const Position pos);
 
+        /// <summary>
+        /// Chords a batch of grids in one pass.
+        /// All positions are validated before any grid is opened,
+        /// and chord conditions are checked against the map as it was before the batch.
+        /// </summary>
+        /// <param name="positions">The positions where to chord.</param>
+        void chord_all(const std::vector<Position>& positions);
+
         /// <summary>
         /// Flags a grid.
         /// </summary>
         /// <param name="pos">The position where to flag.</param>
         void flag(const Position pos);
 
+        /// <summary>
+        /// Flags a batch of grids in one pass.
+        /// All positions are validated before any grid is flagged.
+        /// </summary>
+        /// <param name="positions">The positions where to flag.</param>
+        void flag_all(const std::vector<Position>& positions);
+
         /// <summary>
         /// Gets the game status.
         /// </summary>
@@ -81,16 +239,67 @@ namespace Minesweeper::MineMap
         /// </summary>
         /// <returns>Whether the player wins.</returns>
         bool is_winning() const noexcept;
+
+        /// <summary>
+        /// Sets the flood fill mode. Both modes open exactly the same grids.
+        /// </summary>
+        /// <param name="mode">The flood fill mode.</param>
+        void set_flood_fill_mode(const FloodFillMode mode) noexcept;
+
+        /// <summary>
+        /// Sets the maximum number of threads of a parallel flood fill, including the calling one.
+        /// </summary>
+        /// <param name="threadCount">The number of threads, or 0 to use every thread of the shared thread pool.</param>
+        void set_flood_fill_thread_count(const unsigned int threadCount) noexcept;
+
+        /// <summary>
+        /// Sets the function receiving an event for every opened grid, toggled flag and the end of the game.
+        /// Events are always delivered on the calling thread, including after a parallel flood fill.
+        /// </summary>
+        /// <param name="sink">The event sink, or an empty function to stop receiving events.</param>
+        void set_event_sink(Sink sink);
     private:
         /// <summary>
-        /// The mine map.
+        /// The width of the border stored around a fixed size map. The border grids are open and have no mines,
+        /// so the adjacent grids of any grid can be read without bounds checks. Maps sized at runtime have no border.
+        /// </summary>
+        static constexpr Coordinate BORDER = IS_FIXED_SIZE ? 1 : 0;
+
+        /// <summary>
+        /// The width and height of the tiles of a parallel flood fill.
+        /// Much smaller than the maps filled in parallel, so that every thread finds a tile to fill.
+        /// </summary>
+        static constexpr Coordinate PARALLEL_FLOOD_FILL_TILE_SIZE = 64;
+
+        /// <summary>
+        /// The offsets of the adjacent grids, in the order they are opened.
+        /// </summary>
+        static constexpr std::array<std::pair<int, int>, 8> NEIGHBOUR_OFFSETS = { {
+            { -1, -1 }, { -1, 0 }, { -1, 1 },
+            { 0, -1 }, { 0, 1 },
+            { 1, -1 }, { 1, 0 }, { 1, 1 },
+        } };
+
+        /// <summary>
+        /// A bitmap of the grids, including the border. Each column is packed into 64-bit words, one bit per grid.
         /// </summary>
-        std::vector<std::vector<MineMapValue>> m_mineMap;
+        using Bitmap = GridStorage<std::uint64_t, Width + 2 * BORDER, (Height + 2 * BORDER + 63) / 64>;
 
         /// <summary>
-        /// The grid statuses.
+        /// The mine bitmap.
+        /// Hints are not stored: a hint is a few masked popcounts of this bitmap, evaluated when needed.
         /// </summary>
-        std::vector<std::vector<GridStatus>> m_gridStatus;
+        Bitmap m_mines;
+
+        /// <summary>
+        /// The flag bitmap, kept in step with the flagged grid statuses, so that adjacent flags are counted like adjacent mines.
+        /// </summary>
+        Bitmap m_flags;
+
+        /// <summary>
+        /// The grid statuses, including the border.
+        /// </summary>
+        GridStorage<GridStatus, Width + 2 * BORDER, Height + 2 * BORDER> m_gridStatus;
 
         /// <summary>
         /// The map width.
@@ -113,11 +322,133 @@ namespace Minesweeper::MineMap
         GameStatus m_gameStatus;
 
         /// <summary>
-        /// Fills the mine map with mines and hints.
+        /// The number of grids without mines.
+        /// </summary>
+        std::size_t m_safeGridCount;
+
+        /// <summary>
+        /// The number of opened grids without mines.
+        /// </summary>
+        std::size_t m_openSafeGridCount;
+
+        /// <summary>
+        /// Whether a grid with mine has been opened.
+        /// </summary>
+        bool m_isMineOpened;
+
+        /// <summary>
+        /// Whether the mines have been placed.
+        /// </summary>
+        bool m_areMinesPlaced;
+
+        /// <summary>
+        /// The flood fill mode.
+        /// </summary>
+        FloodFillMode m_floodFillMode;
+
+        /// <summary>
+        /// The maximum number of threads of a parallel flood fill, or 0 for every thread of the shared thread pool.
+        /// </summary>
+        unsigned int m_floodFillThreadCount;
+
+        /// <summary>
+        /// The event sink.
+        /// </summary>
+        Sink m_eventSink;
+
+        /// <summary>
+        /// Initialises the map. Shared by the constructors.
+        /// </summary>
+        /// <param name="width">The width of the map.</param>
+        /// <param name="height">The height of the map.</param>
+        /// <param name="mineCount">The count of mines.</param>
+        void initialise(const std::size_t width, const std::size_t height, const int mineCount);
+
+        /// <summary>
+        /// Places the given mines instead of generating them on the first click.
+        /// </summary>
+        /// <param name="mines">The positions of the mines.</param>
+        void place_mines(const std::vector<Position>& mines);
+
+        /// <summary>
+        /// Gets the map width, which is a constant for a fixed size map.
+        /// </summary>
+        /// <returns>The map width.</returns>
+        constexpr std::size_t get_width() const noexcept;
+
+        /// <summary>
+        /// Gets the map height, which is a constant for a fixed size map.
+        /// </summary>
+        /// <returns>The map height.</returns>
+        constexpr std::size_t get_height() const noexcept;
+
+        /// <summary>
+        /// Opens the seed grids in order, and then the adjacent grids of the empty ones.
+        /// Stops opening seeds once a mine is opened.
+        /// </summary>
+        /// <param name="seeds">The positions to open.</param>
+        void open_grids(const std::span<const Position> seeds);
+
+        /// <summary>
+        /// Gets the closed adjacent grids of a grid if it can be chorded: it is open, and has as many adjacent flags as mines.
+        /// </summary>
+        /// <param name="pos">The position of the chorded grid.</param>
+        /// <param name="seeds">Receives the grids to open.</param>
+        /// <returns>The number of grids to open.</returns>
+        std::size_t get_chord_seeds(const Position pos, std::array<Position, 8>& seeds) const noexcept;
+
+        /// <summary>
+        /// Flags a closed grid, and does nothing otherwise.
+        /// </summary>
+        /// <param name="pos">The position.</param>
+        void flag_grid(const Position pos);
+
+        /// <summary>
+        /// Opens the adjacent grids of the empty grids in the frontier, on the calling thread.
+        /// </summary>
+        /// <param name="frontier">The opened empty grids.</param>
+        void fill_serial(std::vector<Position> frontier);
+
+        /// <summary>
+        /// Opens the adjacent grids of the empty grids in the frontier, on the threads of the shared thread pool.
+        /// The map is split into small square tiles. A thread holds one tile at a time, fills it, and hands
+        /// the grids reaching across its edges to the seed queues of the neighbour tiles. Any idle thread
+        /// picks up any tile with seeds, until no tile has any seed left.
+        /// </summary>
+        /// <param name="frontier">The opened empty grids.</param>
+        void fill_parallel(const std::vector<Position>& frontier);
+
+        /// <summary>
+        /// Opens a single closed grid. Opening a mine sets <see cref="m_isMineOpened"/>.
+        /// </summary>
+        /// <param name="pos">The position.</param>
+        /// <returns>The number of adjacent mines.</returns>
+        int open_grid(const Position pos);
+
+        /// <summary>
+        /// Sends an event to the event sink, if there is one.
+        /// </summary>
+        /// <param name="event">The event.</param>
+        void raise_event(const Event& event) const;
+
+        /// <summary>
+        /// Places the mines at random. Only the mines are sampled, so the time does not depend on the map size.
         /// </summary>
         /// <param name="clickedPos">The position that the player clicks.</param>
         void generate_mines(const Position clickedPos);
 
+        /// <summary>
+        /// Places a mine.
+        /// </summary>
+        /// <param name="pos">The position of the mine.</param>
+        void place_mine(const Position pos) noexcept;
+
+        /// <summary>
+        /// Moves a mine to a random grid without one. If every grid has a mine, the mine is removed instead.
+        /// </summary>
+        /// <param name="pos">The position of the mine.</param>
+        void move_mine(const Position pos);
+
         /// <summary>
         /// Gets the count of the adjacent mines.
         /// </summary>
@@ -125,6 +456,30 @@ namespace Minesweeper::MineMap
         /// <returns>The number of adjacent mines.</returns>
         int get_adjacent_mine_count(const Position pos) const noexcept;
 
+        /// <summary>
+        /// Gets the count of the set bits of a bitmap in part of a column.
+        /// </summary>
+        /// <param name="bitmap">The bitmap.</param>
+        /// <param name="x">The column.</param>
+        /// <param name="yFrom">The first row, inclusive.</param>
+        /// <param name="yTo">The last row, inclusive.</param>
+        /// <returns>The number of set bits.</returns>
+        static int get_column_bit_count(const Bitmap& bitmap, const Coordinate x, const Coordinate yFrom, const Coordinate yTo) noexcept;
+
+        /// <summary>
+        /// Checks if there is a mine at the position.
+        /// </summary>
+        /// <param name="pos">The position.</param>
+        /// <returns>Whether there is a mine.</returns>
+        bool is_mine(const Position pos) const noexcept;
+
+        /// <summary>
+        /// Gets the value of a grid: <see cref="MINE"/>, or the number of adjacent mines.
+        /// </summary>
+        /// <param name="pos">The position.</param>
+        /// <returns>The value of the grid.</returns>
+        Cell get_value(const Position pos) const noexcept;
+
         /// <summary>
         /// Gets the count of the adjacent flags.
         /// </summary>
@@ -132,6 +487,35 @@ namespace Minesweeper::MineMap
         /// <returns>The number of adjacent flags.</returns>
         int get_adjacent_flags(const Position pos) const noexcept;
 
+        /// <summary>
+        /// Gets the bounds of the grids adjacent to a grid, including the grid. Clamped to the map unless there is a border.
+        /// </summary>
+        /// <param name="pos">The position.</param>
+        /// <returns>The first and last X, and the first and last Y, inclusive.</returns>
+        std::tuple<Coordinate, Coordinate, Coordinate, Coordinate> get_adjacent_bounds(const Position pos) const noexcept;
+
+        /// <summary>
+        /// Gets the status of a grid, or of a border grid.
+        /// </summary>
+        /// <param name="pos">The position.</param>
+        /// <returns>The grid status.</returns>
+        GridStatus& get_status(const Position pos) noexcept;
+
+        /// <summary>
+        /// Gets the status of a grid, or of a border grid.
+        /// </summary>
+        /// <param name="pos">The position.</param>
+        /// <returns>The grid status.</returns>
+        GridStatus get_status(const Position pos) const noexcept;
+
+        /// <summary>
+        /// Checks if an adjacent grid of a valid position is stored. Always true with a border,
+        /// so the check compiles away for a fixed size map.
+        /// </summary>
+        /// <param name="pos">The position.</param>
+        /// <returns>Whether the grid is stored.</returns>
+        bool is_stored(const Position pos) const noexcept;
+
         /// <summary>
         /// Checks if the position is valid.
         /// </summary>
@@ -140,6 +524,11 @@ namespace Minesweeper::MineMap
         bool is_valid_position(const Position pos) const noexcept;
     };
 
+    /// <summary>
+    /// The game state with the default coordinate and value types and a map size given at runtime.
+    /// </summary>
+    using MineMap = BasicMineMap<int, MineMapValue>;
+
     /// <summary>
     /// The exception thrown when the mine count is greater than the map size.
     /// </summary>
@@ -170,3 +559,5 @@ namespace Minesweeper::MineMap
         {}
     };
 }
+
+#include "MineMap.inl"
@@ -0,0 +1,876 @@
+#pragma once
+
+namespace Minesweeper::MineMap
+{
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    void BasicMineMap<Coordinate, Cell, Width, Height>::initialise(const std::size_t width, const std::size_t height, const int mineCount)
+    {
+        if (mineCount > width * height)
+        {
+            throw TooManyMinesException();
+        }
+
+        m_width = width;
+        m_height = height;
+        m_mineCount = mineCount;
+
+        if constexpr (IS_FIXED_SIZE)
+        {
+            for (auto& column : m_mines)
+            {
+                column.fill(0);
+            }
+
+            for (auto& column : m_flags)
+            {
+                column.fill(0);
+            }
+
+            for (auto& column : m_gridStatus)
+            {
+                column.fill(GridStatus::closed);
+            }
+
+            // The border grids are open, so they are never opened, flagged or chorded into.
+            m_gridStatus.front().fill(GridStatus::open);
+            m_gridStatus.back().fill(GridStatus::open);
+            for (auto& column : m_gridStatus)
+            {
+                column.front() = GridStatus::open;
+                column.back() = GridStatus::open;
+            }
+        }
+        else
+        {
+            m_mines.resize(width, std::vector<std::uint64_t>((height + 63) / 64, 0));
+            m_flags.resize(width, std::vector<std::uint64_t>((height + 63) / 64, 0));
+            m_gridStatus.resize(width, std::vector<GridStatus>(height, GridStatus::closed));
+        }
+
+        m_gameStatus = not_started;
+        m_safeGridCount = width * height;
+        m_openSafeGridCount = 0;
+        m_isMineOpened = false;
+        m_areMinesPlaced = false;
+        m_floodFillMode = automatic;
+        m_floodFillThreadCount = 0;
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    void BasicMineMap<Coordinate, Cell, Width, Height>::place_mines(const std::vector<Position>& mines)
+    {
+        if (!std::ranges::all_of(mines, [this](const auto& pos) { return is_valid_position(pos); }))
+        {
+            throw PositionOutOfRangeException();
+        }
+
+        std::ranges::for_each(mines, [this](const auto& pos) { place_mine(pos); });
+        m_areMinesPlaced = true;
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    constexpr std::size_t BasicMineMap<Coordinate, Cell, Width, Height>::get_width() const noexcept
+    {
+        if constexpr (IS_FIXED_SIZE)
+        {
+            return Width;
+        }
+        else
+        {
+            return m_width;
+        }
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    constexpr std::size_t BasicMineMap<Coordinate, Cell, Width, Height>::get_height() const noexcept
+    {
+        if constexpr (IS_FIXED_SIZE)
+        {
+            return Height;
+        }
+        else
+        {
+            return m_height;
+        }
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    const std::vector<std::vector<Cell>> BasicMineMap<Coordinate, Cell, Width, Height>::get_minemap() const
+    {
+        auto map = std::vector<std::vector<Cell>>(get_width(), std::vector<Cell>(get_height()));
+
+        for (Coordinate x = 0; x < get_width(); x++)
+        {
+            for (Coordinate y = 0; y < get_height(); y++)
+            {
+                map[x][y] = get_value({ x, y });
+            }
+        }
+
+        return map;
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    const std::vector<std::vector<GridStatus>> BasicMineMap<Coordinate, Cell, Width, Height>::get_grid_status() const
+    {
+        if constexpr (IS_FIXED_SIZE)
+        {
+            // Leave out the border.
+            auto gridStatus = std::vector<std::vector<GridStatus>>();
+            for (auto x = std::size_t(BORDER); x < Width + BORDER; x++)
+            {
+                gridStatus.emplace_back(m_gridStatus[x].begin() + BORDER, m_gridStatus[x].end() - BORDER);
+            }
+
+            return gridStatus;
+        }
+        else
+        {
+            return m_gridStatus;
+        }
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    void BasicMineMap<Coordinate, Cell, Width, Height>::click(const Position pos)
+    {
+        if (m_gameStatus == over)
+        {
+            return;
+        }
+
+        if (!is_valid_position(pos))
+        {
+            throw PositionOutOfRangeException();
+        }
+
+        if (m_gameStatus == not_started)
+        {
+            if (!m_areMinesPlaced)
+            {
+                generate_mines(pos);
+            }
+            else if (is_mine(pos))
+            {
+                // The first click never hits a mine.
+                move_mine(pos);
+            }
+
+            m_gameStatus = started;
+        }
+
+        open_grids(std::span(&pos, 1));
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    void BasicMineMap<Coordinate, Cell, Width, Height>::chord(const Position pos)
+    {
+        if (m_gameStatus == over || m_gameStatus == not_started)
+        {
+            return;
+        }
+
+        if (!is_valid_position(pos))
+        {
+            throw PositionOutOfRangeException();
+        }
+
+        auto seeds = std::array<Position, 8>();
+        const auto seedCount = get_chord_seeds(pos, seeds);
+
+        open_grids(std::span(seeds.data(), seedCount));
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    void BasicMineMap<Coordinate, Cell, Width, Height>::chord_all(const std::vector<Position>& positions)
+    {
+        if (m_gameStatus == over || m_gameStatus == not_started)
+        {
+            return;
+        }
+
+        if (!std::ranges::all_of(positions, [this](const auto& pos) { return is_valid_position(pos); }))
+        {
+            throw PositionOutOfRangeException();
+        }
+
+        // Merge the grids to open from every chord into one frontier.
+        auto seeds = std::vector<Position>();
+        auto chordSeeds = std::array<Position, 8>();
+        for (const auto& pos : positions)
+        {
+            const auto seedCount = get_chord_seeds(pos, chordSeeds);
+            seeds.insert(seeds.end(), chordSeeds.begin(), chordSeeds.begin() + seedCount);
+        }
+
+        open_grids(seeds);
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    std::size_t BasicMineMap<Coordinate, Cell, Width, Height>::get_chord_seeds(const Position pos, std::array<Position, 8>& seeds) const noexcept
+    {
+        if (get_status(pos) != open || get_adjacent_flags(pos) != get_adjacent_mine_count(pos))
+        {
+            return 0;
+        }
+
+        auto seedCount = std::size_t(0);
+        for (const auto& [dx, dy] : NEIGHBOUR_OFFSETS)
+        {
+            const auto adjacentPos = Position(pos.first + dx, pos.second + dy);
+            if (is_stored(adjacentPos) && get_status(adjacentPos) == closed)
+            {
+                seeds[seedCount++] = adjacentPos;
+            }
+        }
+
+        return seedCount;
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    void BasicMineMap<Coordinate, Cell, Width, Height>::flag(const Position pos)
+    {
+        if (m_gameStatus == over)
+        {
+            return;
+        }
+
+        if (!is_valid_position(pos))
+        {
+            throw PositionOutOfRangeException();
+        }
+
+        flag_grid(pos);
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    void BasicMineMap<Coordinate, Cell, Width, Height>::flag_all(const std::vector<Position>& positions)
+    {
+        if (m_gameStatus == over)
+        {
+            return;
+        }
+
+        if (!std::ranges::all_of(positions, [this](const auto& pos) { return is_valid_position(pos); }))
+        {
+            throw PositionOutOfRangeException();
+        }
+
+        for (const auto& pos : positions)
+        {
+            flag_grid(pos);
+        }
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    void BasicMineMap<Coordinate, Cell, Width, Height>::flag_grid(const Position pos)
+    {
+        auto& status = get_status(pos);
+
+        if (status != closed)
+        {
+            return;
+        }
+
+        status = status == flagged ? closed : flagged;
+
+        const auto bit = pos.second + BORDER;
+        const auto mask = std::uint64_t(1) << (bit % 64);
+        if (status == flagged)
+        {
+            m_flags[pos.first + BORDER][bit / 64] |= mask;
+        }
+        else
+        {
+            m_flags[pos.first + BORDER][bit / 64] &= ~mask;
+        }
+
+        raise_event({ .type = flag_toggled, .pos = pos, .status = status });
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    const GameStatus BasicMineMap<Coordinate, Cell, Width, Height>::get_game_status() const noexcept
+    {
+        return m_gameStatus;
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    bool BasicMineMap<Coordinate, Cell, Width, Height>::is_winning() const noexcept
+    {
+        // Clicked grid with mine, or still got closed empty grids or wrong flags.
+        return m_gameStatus != not_started && !m_isMineOpened && m_openSafeGridCount == m_safeGridCount;
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    void BasicMineMap<Coordinate, Cell, Width, Height>::open_grids(const std::span<const Position> seeds)
+    {
+        auto frontier = std::vector<Position>();
+
+        for (const auto& pos : seeds)
+        {
+            if (get_status(pos) != closed)
+            {
+                continue;
+            }
+
+            const auto hint = open_grid(pos);
+
+            if (m_isMineOpened)
+            {
+                m_gameStatus = over;
+                break;
+            }
+
+            if (hint == EMPTY)
+            {
+                frontier.push_back(pos);
+            }
+        }
+
+        // Open adjacent grids of the empty ones.
+        if (!frontier.empty())
+        {
+            const auto useParallel = m_floodFillMode == parallel
+                || (m_floodFillMode == automatic && get_width() * get_height() >= PARALLEL_FLOOD_FILL_MIN_SIZE && Minesweeper::Utils::ThreadPool::get_shared().get_worker_count() > 0);
+
+            if (useParallel)
+            {
+                fill_parallel(frontier);
+            }
+            else
+            {
+                fill_serial(std::move(frontier));
+            }
+        }
+
+        if (is_winning())
+        {
+            m_gameStatus = over;
+        }
+
+        if (m_gameStatus == over)
+        {
+            raise_event({ .type = game_over, .isWinning = is_winning() });
+        }
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    void BasicMineMap<Coordinate, Cell, Width, Height>::fill_serial(std::vector<Position> frontier)
+    {
+        while (!frontier.empty())
+        {
+            const auto [x, y] = frontier.back();
+            frontier.pop_back();
+
+            for (const auto& [dx, dy] : NEIGHBOUR_OFFSETS)
+            {
+                const auto adjacentPos = Position(x + dx, y + dy);
+                if (is_stored(adjacentPos)
+                    && get_status(adjacentPos) == closed
+                    && open_grid(adjacentPos) == EMPTY)
+                {
+                    frontier.push_back(adjacentPos);
+                }
+            }
+        }
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    void BasicMineMap<Coordinate, Cell, Width, Height>::fill_parallel(const std::vector<Position>& frontier)
+    {
+        const auto tileRowCount = (get_height() + PARALLEL_FLOOD_FILL_TILE_SIZE - 1) / PARALLEL_FLOOD_FILL_TILE_SIZE;
+        const auto tileCount = (get_width() + PARALLEL_FLOOD_FILL_TILE_SIZE - 1) / PARALLEL_FLOOD_FILL_TILE_SIZE * tileRowCount;
+
+        // A square of the map. Only the thread holding a tile touches the grids inside it.
+        struct Tile
+        {
+            // Guards the seeds and whether the tile is scheduled.
+            std::mutex mutex;
+
+            // The grids handed over by the neighbour tiles, to be opened if still closed.
+            std::vector<Position> seeds;
+
+            // Whether the tile is waiting in the ready queue or held by a thread.
+            bool isScheduled = false;
+        };
+
+        // The results of a thread.
+        struct Worker
+        {
+            // The number of grids opened by this thread.
+            std::size_t openCount = 0;
+
+            // The grids opened by this thread, only recorded when there is an event sink.
+            std::vector<Position> opened;
+        };
+
+        auto tiles = std::vector<Tile>(tileCount);
+
+        // The tiles waiting for a thread, and the number of tiles waiting or held.
+        // The fill is over once no tile is scheduled, as only a held tile can hand seeds over.
+        auto queueMutex = std::mutex();
+        auto queueCondition = std::condition_variable();
+        auto readyTiles = std::vector<std::size_t>();
+        auto scheduledCount = std::size_t(0);
+        auto isAborted = false;
+
+        auto get_tile_index = [&](const Position pos) {
+            return static_cast<std::size_t>(pos.first / PARALLEL_FLOOD_FILL_TILE_SIZE) * tileRowCount
+                + static_cast<std::size_t>(pos.second / PARALLEL_FLOOD_FILL_TILE_SIZE);
+        };
+
+        // Hands seeds over to a tile, and schedules it unless it already is.
+        auto send_seeds = [&](const std::size_t index, std::vector<Position>& seeds) {
+            auto& tile = tiles[index];
+            auto isNewlyScheduled = false;
+
+            {
+                auto lock = std::lock_guard(tile.mutex);
+                tile.seeds.insert(tile.seeds.end(), seeds.begin(), seeds.end());
+                isNewlyScheduled = !tile.isScheduled;
+                tile.isScheduled = true;
+            }
+
+            seeds.clear();
+
+            if (isNewlyScheduled)
+            {
+                {
+                    auto lock = std::lock_guard(queueMutex);
+                    readyTiles.push_back(index);
+                    scheduledCount++;
+                }
+
+                queueCondition.notify_one();
+            }
+        };
+
+        // The adjacent grids of the frontier are the first seeds.
+        {
+            auto seeds = std::map<std::size_t, std::vector<Position>>();
+            for (const auto& [x, y] : frontier)
+            {
+                for (const auto& [dx, dy] : NEIGHBOUR_OFFSETS)
+                {
+                    const auto adjacentPos = Position(x + dx, y + dy);
+                    if (is_valid_position(adjacentPos))
+                    {
+                        seeds[get_tile_index(adjacentPos)].push_back(adjacentPos);
+                    }
+                }
+            }
+
+            for (auto& [index, tileSeeds] : seeds)
+            {
+                send_seeds(index, tileSeeds);
+            }
+        }
+
+        auto& pool = Minesweeper::Utils::ThreadPool::get_shared();
+        const auto threadCount = std::min(m_floodFillThreadCount == 0 ? pool.get_worker_count() + 1 : m_floodFillThreadCount, pool.get_worker_count() + 1);
+        const auto isRecording = static_cast<bool>(m_eventSink);
+
+        auto workers = std::vector<Worker>(threadCount);
+        auto nextWorkerIndex = std::atomic<unsigned int>(0);
+
+        auto fill_tiles = [&] {
+            auto& worker = workers[nextWorkerIndex++];
+            auto seeds = std::vector<Position>();
+            auto tileFrontier = std::vector<Position>();
+
+            // The seeds for the tiles around the held one, by the tile offset (dx + 1) * 3 + (dy + 1).
+            auto outboxes = std::array<std::vector<Position>, 9>();
+
+            try
+            {
+                for (;;)
+                {
+                    auto index = std::size_t(0);
+
+                    {
+                        auto lock = std::unique_lock(queueMutex);
+                        queueCondition.wait(lock, [&] { return isAborted || !readyTiles.empty() || scheduledCount == 0; });
+
+                        if (isAborted || readyTiles.empty())
+                        {
+                            return;
+                        }
+
+                        index = readyTiles.back();
+                        readyTiles.pop_back();
+                    }
+
+                    auto& tile = tiles[index];
+                    const auto tileX = static_cast<Coordinate>(index / tileRowCount);
+                    const auto tileY = static_cast<Coordinate>(index % tileRowCount);
+
+                    // Opens a grid of this tile, and queues it if it is empty.
+                    auto open_local = [&](const Position pos) {
+                        auto& status = get_status(pos);
+                        if (status != closed)
+                        {
+                            return;
+                        }
+
+                        // Grids adjacent to an empty grid are never mines.
+                        status = open;
+                        worker.openCount++;
+
+                        if (isRecording)
+                        {
+                            worker.opened.push_back(pos);
+                        }
+
+                        if (get_adjacent_mine_count(pos) == EMPTY)
+                        {
+                            tileFrontier.push_back(pos);
+                        }
+                    };
+
+                    // Keep the tile until no seeds are left, as new ones may arrive while it is being filled.
+                    for (;;)
+                    {
+                        {
+                            auto lock = std::lock_guard(tile.mutex);
+                            seeds.swap(tile.seeds);
+                            if (seeds.empty())
+                            {
+                                tile.isScheduled = false;
+                                break;
+                            }
+                        }
+
+                        for (const auto& pos : seeds)
+                        {
+                            open_local(pos);
+                        }
+                        seeds.clear();
+
+                        while (!tileFrontier.empty())
+                        {
+                            const auto [x, y] = tileFrontier.back();
+                            tileFrontier.pop_back();
+
+                            for (const auto& [dx, dy] : NEIGHBOUR_OFFSETS)
+                            {
+                                const auto adjacentPos = Position(x + dx, y + dy);
+                                if (!is_valid_position(adjacentPos))
+                                {
+                                    continue;
+                                }
+
+                                const auto dxTile = adjacentPos.first / PARALLEL_FLOOD_FILL_TILE_SIZE - tileX;
+                                const auto dyTile = adjacentPos.second / PARALLEL_FLOOD_FILL_TILE_SIZE - tileY;
+                                if (dxTile == 0 && dyTile == 0)
+                                {
+                                    open_local(adjacentPos);
+                                }
+                                else
+                                {
+                                    outboxes[(dxTile + 1) * 3 + (dyTile + 1)].push_back(adjacentPos);
+                                }
+                            }
+                        }
+
+                        for (auto i = 0; i < 9; i++)
+                        {
+                            if (!outboxes[i].empty())
+                            {
+                                send_seeds(get_tile_index(outboxes[i].front()), outboxes[i]);
+                            }
+                        }
+                    }
+
+                    auto lock = std::lock_guard(queueMutex);
+                    if (--scheduledCount == 0)
+                    {
+                        queueCondition.notify_all();
+                    }
+                }
+            }
+            catch (...)
+            {
+                // Release the other threads instead of leaving them waiting for this tile.
+                {
+                    auto lock = std::lock_guard(queueMutex);
+                    isAborted = true;
+                }
+
+                queueCondition.notify_all();
+                throw;
+            }
+        };
+
+        pool.run(fill_tiles, threadCount);
+
+        for (const auto& worker : workers)
+        {
+            m_openSafeGridCount += worker.openCount;
+
+            for (const auto& pos : worker.opened)
+            {
+                raise_event({ .type = grid_opened, .pos = pos, .value = get_value(pos) });
+            }
+        }
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    int BasicMineMap<Coordinate, Cell, Width, Height>::open_grid(const Position pos)
+    {
+        get_status(pos) = open;
+
+        // The mine bit decides the outcome. MINE only appears in the value reported to the event sink.
+        const auto hint = get_adjacent_mine_count(pos);
+        const auto isMine = is_mine(pos);
+        if (isMine)
+        {
+            m_isMineOpened = true;
+        }
+        else
+        {
+            m_openSafeGridCount++;
+        }
+
+        raise_event({ .type = grid_opened, .pos = pos, .value = isMine ? MINE : static_cast<Cell>(hint) });
+
+        return hint;
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    void BasicMineMap<Coordinate, Cell, Width, Height>::raise_event(const Event& event) const
+    {
+        if (m_eventSink)
+        {
+            m_eventSink(event);
+        }
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    void BasicMineMap<Coordinate, Cell, Width, Height>::set_flood_fill_mode(const FloodFillMode mode) noexcept
+    {
+        m_floodFillMode = mode;
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    void BasicMineMap<Coordinate, Cell, Width, Height>::set_flood_fill_thread_count(const unsigned int threadCount) noexcept
+    {
+        m_floodFillThreadCount = threadCount;
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    void BasicMineMap<Coordinate, Cell, Width, Height>::set_event_sink(Sink sink)
+    {
+        m_eventSink = std::move(sink);
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    void BasicMineMap<Coordinate, Cell, Width, Height>::generate_mines(const Position clickedPos)
+    {
+        if (!is_valid_position(clickedPos))
+        {
+            throw PositionOutOfRangeException();
+        }
+
+        m_gameStatus = started;
+
+        // Number the usable grids by X and then Y, skipping the clicked grid, which will not have mine.
+        const auto height = get_height();
+        const auto clickedIndex = clickedPos.first * height + clickedPos.second;
+        const auto usableCount = get_width() * height - 1;
+        auto get_position = [&](const std::size_t index) {
+            const auto gridIndex = index < clickedIndex ? index : index + 1;
+            return Position(static_cast<Coordinate>(gridIndex / height), static_cast<Coordinate>(gridIndex % height));
+        };
+
+        // Floyd's algorithm samples the mines without building the list of all grids, using the bitmap as the set of picked ones.
+        // Only the mines are placed here. Hints are evaluated when the grids are opened.
+        auto random = std::mt19937(std::random_device()());
+        for (auto i = usableCount - std::min<std::size_t>(m_mineCount, usableCount); i < usableCount; i++)
+        {
+            const auto pos = get_position(std::uniform_int_distribution<std::size_t>(0, i)(random));
+            place_mine(is_mine(pos) ? get_position(i) : pos);
+        }
+
+        m_areMinesPlaced = true;
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    void BasicMineMap<Coordinate, Cell, Width, Height>::place_mine(const Position pos) noexcept
+    {
+        if (is_mine(pos))
+        {
+            return;
+        }
+
+        const auto bit = pos.second + BORDER;
+        m_mines[pos.first + BORDER][bit / 64] |= std::uint64_t(1) << (bit % 64);
+        m_safeGridCount--;
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    void BasicMineMap<Coordinate, Cell, Width, Height>::move_mine(const Position pos)
+    {
+        // The grid of the mine is not free, so the free grids are the safe ones.
+        const auto freeCount = m_safeGridCount;
+
+        const auto bit = pos.second + BORDER;
+        m_mines[pos.first + BORDER][bit / 64] &= ~(std::uint64_t(1) << (bit % 64));
+        m_safeGridCount++;
+
+        // Every grid has a mine. Like the generated maps, keep the clicked grid free and drop the mine.
+        if (freeCount == 0)
+        {
+            return;
+        }
+
+        // Pick the free grid of a random rank, skipping whole columns by their mine counts.
+        auto random = std::mt19937(std::random_device()());
+        auto rank = std::uniform_int_distribution<std::size_t>(0, freeCount - 1)(random);
+        const auto yTo = static_cast<Coordinate>(get_height()) - 1;
+
+        for (Coordinate x = 0; x < get_width(); x++)
+        {
+            // The moved mine is already removed, but its grid is not free.
+            const auto columnFreeCount = get_height() - get_column_bit_count(m_mines, x, 0, yTo) - (x == pos.first ? 1 : 0);
+            if (rank >= columnFreeCount)
+            {
+                rank -= columnFreeCount;
+                continue;
+            }
+
+            for (Coordinate y = 0; y < get_height(); y++)
+            {
+                if (is_mine({ x, y }) || Position(x, y) == pos)
+                {
+                    continue;
+                }
+
+                if (rank == 0)
+                {
+                    place_mine({ x, y });
+                    return;
+                }
+
+                rank--;
+            }
+        }
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    int BasicMineMap<Coordinate, Cell, Width, Height>::get_adjacent_mine_count(const Position pos) const noexcept
+    {
+        const auto [xFrom, xTo, yFrom, yTo] = get_adjacent_bounds(pos);
+
+        auto count = 0;
+        for (auto x = xFrom; x <= xTo; x++)
+        {
+            count += get_column_bit_count(m_mines, x, yFrom, yTo);
+        }
+
+        // The center grid is not adjacent to itself.
+        return count - (is_mine(pos) ? 1 : 0);
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    int BasicMineMap<Coordinate, Cell, Width, Height>::get_column_bit_count(const Bitmap& bitmap, const Coordinate x, const Coordinate yFrom, const Coordinate yTo) noexcept
+    {
+        const auto& column = bitmap[x + BORDER];
+        const auto bitFrom = yFrom + BORDER;
+        const auto bitTo = yTo + BORDER;
+        auto count = 0;
+
+        for (auto word = bitFrom / 64; word <= bitTo / 64; word++)
+        {
+            // Mask out the bits outside [bitFrom, bitTo] in this word.
+            const auto low = std::max<Coordinate>(bitFrom - word * 64, 0);
+            const auto high = std::min<Coordinate>(bitTo - word * 64, 63);
+            const auto mask = (~std::uint64_t(0) >> (63 - high)) & (~std::uint64_t(0) << low);
+
+            count += std::popcount(column[word] & mask);
+        }
+
+        return count;
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    bool BasicMineMap<Coordinate, Cell, Width, Height>::is_mine(const Position pos) const noexcept
+    {
+        const auto bit = pos.second + BORDER;
+        return (m_mines[pos.first + BORDER][bit / 64] >> (bit % 64)) & 1;
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    Cell BasicMineMap<Coordinate, Cell, Width, Height>::get_value(const Position pos) const noexcept
+    {
+        return is_mine(pos) ? MINE : static_cast<Cell>(get_adjacent_mine_count(pos));
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    int BasicMineMap<Coordinate, Cell, Width, Height>::get_adjacent_flags(const Position pos) const noexcept
+    {
+        const auto [xFrom, xTo, yFrom, yTo] = get_adjacent_bounds(pos);
+
+        // Count the flags of each column with a masked popcount, like the adjacent mines.
+        auto count = 0;
+        for (auto x = xFrom; x <= xTo; x++)
+        {
+            count += get_column_bit_count(m_flags, x, yFrom, yTo);
+        }
+
+        // The center grid is not adjacent to itself.
+        return count - (get_status(pos) == flagged ? 1 : 0);
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    std::tuple<Coordinate, Coordinate, Coordinate, Coordinate> BasicMineMap<Coordinate, Cell, Width, Height>::get_adjacent_bounds(const Position pos) const noexcept
+    {
+        if constexpr (IS_FIXED_SIZE)
+        {
+            // The border is stored, so there is nothing to clamp.
+            return { pos.first - 1, pos.first + 1, pos.second - 1, pos.second + 1 };
+        }
+        else
+        {
+            return {
+                std::max<Coordinate>(pos.first - 1, 0),
+                std::min<Coordinate>(pos.first + 1, static_cast<Coordinate>(get_width()) - 1),
+                std::max<Coordinate>(pos.second - 1, 0),
+                std::min<Coordinate>(pos.second + 1, static_cast<Coordinate>(get_height()) - 1),
+            };
+        }
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    GridStatus& BasicMineMap<Coordinate, Cell, Width, Height>::get_status(const Position pos) noexcept
+    {
+        return m_gridStatus[pos.first + BORDER][pos.second + BORDER];
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    GridStatus BasicMineMap<Coordinate, Cell, Width, Height>::get_status(const Position pos) const noexcept
+    {
+        return m_gridStatus[pos.first + BORDER][pos.second + BORDER];
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    bool BasicMineMap<Coordinate, Cell, Width, Height>::is_stored(const Position pos) const noexcept
+    {
+        if constexpr (IS_FIXED_SIZE)
+        {
+            return true;
+        }
+        else
+        {
+            return is_valid_position(pos);
+        }
+    }
+
+    template <typename Coordinate, typename Cell, std::size_t Width, std::size_t Height>
+    bool BasicMineMap<Coordinate, Cell, Width, Height>::is_valid_position(const Position pos) const noexcept
+    {
+        // Negative coordinates wrap around to large unsigned values, so one comparison per axis is enough.
+        using Unsigned = std::make_unsigned_t<Coordinate>;
+        return (static_cast<Unsigned>(pos.first) < get_width()) & (static_cast<Unsigned>(pos.second) < get_height());
+    }
+
+    extern template class BasicMineMap<int, MineMapValue>;
+}
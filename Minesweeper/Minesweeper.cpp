@@ -1,12 +1,36 @@
 #include <iostream>
+#include <optional>
 #include <stdexcept>
+#include <string>
 
+#include "Benchmark.h"
 #include "MineMap.h"
 #include "OutputFormatUtils.h"
 #include "Parser.h"
 
-int main()
+int main(int argc, char* argv[])
 {
+    // "Minesweeper --bench [min_games_per_second]" runs the benchmark without prompting,
+    // and exits with 0 if it passes or 1 if it fails. Without a minimum, the floor recorded for each board is used.
+    if (argc >= 2 && std::string(argv[1]) == "--bench")
+    {
+        try
+        {
+            const auto minGamesPerSecond = argc >= 3 ? std::optional(std::stod(argv[2])) : std::nullopt;
+            return Minesweeper::Benchmarks::run_benchmarks(minGamesPerSecond) ? 0 : 1;
+        }
+        catch (std::invalid_argument&)
+        {
+            std::cout << "Invalid argument." << std::endl;
+            return 2;
+        }
+        catch (std::out_of_range&)
+        {
+            std::cout << "Out of range." << std::endl;
+            return 2;
+        }
+    }
+
     std::cout << "===== MINESWEEPER =====" << std::endl;
 
     auto game = Minesweeper::MineMap::MineMap(10, 10, 10);
@@ -1,16 +1,40 @@
 #include <algorithm>
 #include <functional>
 #include <iostream>
+#include <optional>
 #include <ranges>
 #include <stdexcept>
 #include <string>
+#include <thread>
 
+#include "Benchmark.h"
+#include "BoardPool.h"
 #include "MineMap.h"
 #include "OutputFormatUtils.h"
 #include "Parser.h"
 
 namespace Minesweeper::Parsers
 {
+    /// <summary>
+    /// The maximum number of ready-made boards for each map size.
+    /// </summary>
+    const std::size_t BOARD_POOL_CAPACITY = 4;
+
+    /// <summary>
+    /// The maximum number of bytes of the ready-made boards of every map size together.
+    /// </summary>
+    const std::size_t BOARD_POOL_MEMORY_BUDGET = std::size_t(256) << 20;
+
+    /// <summary>
+    /// Gets the pool of ready-made boards for new games.
+    /// </summary>
+    /// <returns>The board pool.</returns>
+    Minesweeper::Services::BoardPool& get_board_pool()
+    {
+        static auto pool = Minesweeper::Services::BoardPool(BOARD_POOL_CAPACITY, BOARD_POOL_MEMORY_BUDGET, std::max(std::thread::hardware_concurrency(), 2u) - 1);
+        return pool;
+    }
+
     Callback parse(const std::string_view input)
     {
         auto tokens_view = input
@@ -49,7 +73,7 @@ namespace Minesweeper::Parsers
             auto [width, height, mineCount] = std::tuple{ std::stoi(tokens[1].data()), std::stoi(tokens[2].data()), std::stoi(tokens[3].data()) };
 
             return [width, height, mineCount](auto& mineMap) {
-                mineMap = Minesweeper::MineMap::MineMap(width, height, mineCount);
+                mineMap = get_board_pool().acquire(width, height, mineCount);
                 Minesweeper::Utils::print_game_state(mineMap);
             };
         }
@@ -101,6 +125,21 @@ namespace Minesweeper::Parsers
                 Minesweeper::Utils::print_game_state(mineMap);
             };
         }
+        else if (iequals(cmd, "bench") || iequals(cmd, "b"))
+        {
+            if (tokens.size() > 2)
+            {
+                return [](auto& _) {
+                    throw std::invalid_argument("Invalid argument.");
+                };
+            }
+
+            auto minGamesPerSecond = tokens.size() == 2 ? std::optional(std::stod(tokens[1].data())) : std::nullopt;
+
+            return [minGamesPerSecond](auto& _) {
+                Minesweeper::Benchmarks::run_benchmarks(minGamesPerSecond);
+            };
+        }
         else if (iequals(cmd, "help") || iequals(cmd, "h") || iequals(cmd, "?"))
         {
             return [](auto& _) {
@@ -108,6 +147,7 @@ namespace Minesweeper::Parsers
                     << "{click|c} x y : Clicks a grid." << std::endl
                     << "{chord|x} x y : Checks if adjacent square can be opened automatically." << std::endl
                     << "{flag|f} x y : Marks a square as mine with flag (X)." << std::endl
+                    << "{bench|b} [min_games_per_second] : Runs the solver benchmark on every engine." << std::endl
                     << "{help|h|?} : Shows this help." << std::endl
                     << "{exit|quit|q} : Exits." << std::endl
                     << std::endl
@@ -0,0 +1,531 @@
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <tuple>
+
+#include "SparseMineMap.h"
+
+namespace Minesweeper::MineMap
+{
+    SparseMineMap::SparseMineMap(const std::size_t width, const std::size_t height, const int mineCount)
+        : m_width(width), m_height(height), m_mineCount(mineCount)
+    {
+        if (mineCount > width * height)
+        {
+            throw TooManyMinesException();
+        }
+
+        m_gameStatus = not_started;
+        m_safeGridCount = width * height;
+        m_openSafeGridCount = 0;
+        m_isMineOpened = false;
+        m_areMinesPlaced = false;
+    }
+
+    SparseMineMap::SparseMineMap(const std::size_t width, const std::size_t height, const std::vector<Position>& mines)
+        : SparseMineMap(width, height, static_cast<int>(mines.size()))
+    {
+        if (!std::ranges::all_of(mines, [this](const auto& pos) { return is_valid_position(pos); }))
+        {
+            throw PositionOutOfRangeException();
+        }
+
+        m_mines.insert(mines.begin(), mines.end());
+        m_safeGridCount -= m_mines.size();
+        m_areMinesPlaced = true;
+    }
+
+    const std::vector<std::vector<MineMapValue>> SparseMineMap::get_minemap() const
+    {
+        auto map = std::vector<std::vector<MineMapValue>>(m_width, std::vector<MineMapValue>(m_height, MineMapValue(MineMap::EMPTY)));
+
+        for (const auto& [x, y] : m_mines)
+        {
+            map[x][y] = MineMap::MINE;
+        }
+
+        // Add one to every grid around each mine.
+        for (const auto& [x, y] : m_mines)
+        {
+            for (auto i = x - 1; i <= x + 1; i++)
+            {
+                for (auto j = y - 1; j <= y + 1; j++)
+                {
+                    if (is_valid_position({ i, j }) && map[i][j] != MineMap::MINE)
+                    {
+                        map[i][j]++;
+                    }
+                }
+            }
+        }
+
+        return map;
+    }
+
+    const std::vector<std::vector<GridStatus>> SparseMineMap::get_grid_status() const
+    {
+        auto gridStatus = std::vector<std::vector<GridStatus>>(m_width, std::vector<GridStatus>(m_height, GridStatus::closed));
+
+        for (const auto& [x, y] : m_flags)
+        {
+            gridStatus[x][y] = flagged;
+        }
+
+        for (const auto& [x, runs] : m_openRuns)
+        {
+            for (const auto& [yFrom, yTo] : runs)
+            {
+                std::fill(gridStatus[x].begin() + yFrom, gridStatus[x].begin() + yTo + 1, open);
+            }
+        }
+
+        return gridStatus;
+    }
+
+    void SparseMineMap::click(const Position pos)
+    {
+        if (m_gameStatus == over)
+        {
+            return;
+        }
+
+        if (!is_valid_position(pos))
+        {
+            throw PositionOutOfRangeException();
+        }
+
+        if (m_gameStatus == not_started)
+        {
+            if (!m_areMinesPlaced)
+            {
+                generate_mines(pos);
+            }
+            else if (m_mines.contains(pos))
+            {
+                // The first click never hits a mine.
+                move_mine(pos);
+            }
+
+            m_gameStatus = started;
+        }
+
+        open_grids({ pos });
+    }
+
+    void SparseMineMap::chord(const Position pos)
+    {
+        if (m_gameStatus == over || m_gameStatus == not_started)
+        {
+            return;
+        }
+
+        if (!is_valid_position(pos))
+        {
+            throw PositionOutOfRangeException();
+        }
+
+        if (!is_open(pos) || get_adjacent_count(m_flags, pos) != get_value(pos))
+        {
+            return;
+        }
+
+        // Open adjacent grids.
+        auto seeds = std::vector<Position>();
+        for (auto i = pos.first - 1; i <= pos.first + 1; i++)
+        {
+            for (auto j = pos.second - 1; j <= pos.second + 1; j++)
+            {
+                if (is_valid_position({ i, j }) && is_closed({ i, j }))
+                {
+                    seeds.push_back(Position(i, j));
+                }
+            }
+        }
+
+        open_grids(seeds);
+    }
+
+    void SparseMineMap::flag(const Position pos)
+    {
+        if (m_gameStatus == over)
+        {
+            return;
+        }
+
+        if (!is_valid_position(pos))
+        {
+            throw PositionOutOfRangeException();
+        }
+
+        if (!is_closed(pos))
+        {
+            return;
+        }
+
+        m_flags.insert(pos);
+        raise_event({ .type = flag_toggled, .pos = pos, .status = flagged });
+    }
+
+    const GameStatus SparseMineMap::get_game_status() const noexcept
+    {
+        return m_gameStatus;
+    }
+
+    bool SparseMineMap::is_winning() const noexcept
+    {
+        // Clicked grid with mine, or still got closed empty grids or wrong flags.
+        return m_gameStatus != not_started && !m_isMineOpened && m_openSafeGridCount == m_safeGridCount;
+    }
+
+    void SparseMineMap::set_event_sink(EventSink sink)
+    {
+        m_eventSink = std::move(sink);
+    }
+
+    void SparseMineMap::generate_mines(const Position clickedPos)
+    {
+        // The clicked grid will not have mine.
+        const auto mineCount = std::min<std::size_t>(m_mineCount, m_width * m_height - 1);
+
+        // Pick random positions until we have enough. This is meant for maps with few mines.
+        auto random = std::mt19937(std::random_device()());
+        auto xDistribution = std::uniform_int_distribution<int>(0, static_cast<int>(m_width) - 1);
+        auto yDistribution = std::uniform_int_distribution<int>(0, static_cast<int>(m_height) - 1);
+
+        while (m_mines.size() < mineCount)
+        {
+            const auto pos = Position(xDistribution(random), yDistribution(random));
+            if (pos != clickedPos)
+            {
+                m_mines.insert(pos);
+            }
+        }
+
+        m_safeGridCount -= mineCount;
+        m_areMinesPlaced = true;
+    }
+
+    void SparseMineMap::move_mine(const Position pos)
+    {
+        // The grid of the mine is not free, so the free grids are the safe ones.
+        const auto freeCount = m_safeGridCount;
+
+        // Every grid has a mine. Like the generated maps, keep the clicked grid free and drop the mine.
+        if (freeCount == 0)
+        {
+            m_mines.erase(pos);
+            m_safeGridCount++;
+            return;
+        }
+
+        // Number the grids by X and then Y, and find the free grid of a random rank.
+        // The mines are sorted in the same order, so each mine up to it shifts it by one.
+        auto random = std::mt19937(std::random_device()());
+        auto index = std::uniform_int_distribution<std::size_t>(0, freeCount - 1)(random);
+        for (const auto& [x, y] : m_mines)
+        {
+            if (x * m_height + y > index)
+            {
+                break;
+            }
+
+            index++;
+        }
+
+        m_mines.erase(pos);
+        m_mines.insert(Position(static_cast<int>(index / m_height), static_cast<int>(index % m_height)));
+    }
+
+    void SparseMineMap::open_grids(const std::vector<Position>& seeds)
+    {
+        auto frontier = std::vector<Position>();
+
+        for (const auto& pos : seeds)
+        {
+            if (!is_closed(pos))
+            {
+                continue;
+            }
+
+            const auto value = get_value(pos);
+
+            open_run(pos.first, pos.second, pos.second);
+            raise_event({ .type = grid_opened, .pos = pos, .value = value });
+
+            if (value == MineMap::MINE)
+            {
+                m_isMineOpened = true;
+                m_gameStatus = over;
+                break;
+            }
+
+            m_openSafeGridCount++;
+
+            if (value == MineMap::EMPTY)
+            {
+                frontier.push_back(pos);
+            }
+        }
+
+        // Open adjacent grids of the empty ones.
+        fill(std::move(frontier));
+
+        if (is_winning())
+        {
+            m_gameStatus = over;
+        }
+
+        if (m_gameStatus == over)
+        {
+            raise_event({ .type = game_over, .isWinning = is_winning() });
+        }
+    }
+
+    void SparseMineMap::fill(std::vector<Position> frontier)
+    {
+        const auto height = static_cast<int>(m_height);
+
+        // The runs of open empty grids whose adjacent grids may still be closed, as the X coordinate and the first and last Y coordinates.
+        // Each empty grid is in at most one queued run, as only newly opened grids are queued.
+        auto runs = std::vector<std::tuple<int, int, int>>();
+        for (const auto& [x, y] : frontier)
+        {
+            runs.push_back({ x, y, y });
+        }
+
+        while (!runs.empty())
+        {
+            const auto [x, runFrom, runTo] = runs.back();
+            runs.pop_back();
+
+            // Extend over the closed empty grids on both ends, which all open each other.
+            auto yFrom = runFrom;
+            while (yFrom > 0 && is_closed({ x, yFrom - 1 }) && get_value({ x, yFrom - 1 }) == MineMap::EMPTY)
+            {
+                yFrom--;
+            }
+
+            auto yTo = runTo;
+            while (yTo < height - 1 && is_closed({ x, yTo + 1 }) && get_value({ x, yTo + 1 }) == MineMap::EMPTY)
+            {
+                yTo++;
+            }
+
+            if (yFrom < runFrom || yTo > runTo)
+            {
+                m_openSafeGridCount += open_run(x, yFrom, yTo);
+
+                for (auto y = yFrom; y < runFrom; y++)
+                {
+                    raise_event({ .type = grid_opened, .pos = Position(x, y), .value = MineMap::EMPTY });
+                }
+
+                for (auto y = runTo + 1; y <= yTo; y++)
+                {
+                    raise_event({ .type = grid_opened, .pos = Position(x, y), .value = MineMap::EMPTY });
+                }
+            }
+
+            // Open every closed grid around the run, one segment at a time, and queue the runs of empty grids among them.
+            for (const auto i : { x - 1, x, x + 1 })
+            {
+                if (i < 0 || i >= static_cast<int>(m_width))
+                {
+                    continue;
+                }
+
+                for (const auto& [segmentFrom, segmentTo] : get_closed_runs(i, std::max(yFrom - 1, 0), std::min(yTo + 1, height - 1)))
+                {
+                    const auto values = get_values(i, segmentFrom, segmentTo);
+                    m_openSafeGridCount += open_run(i, segmentFrom, segmentTo);
+
+                    auto emptyFrom = -1;
+                    for (auto j = segmentFrom; j <= segmentTo; j++)
+                    {
+                        const auto value = values[j - segmentFrom];
+                        raise_event({ .type = grid_opened, .pos = Position(i, j), .value = value });
+
+                        if (value == MineMap::EMPTY && emptyFrom < 0)
+                        {
+                            emptyFrom = j;
+                        }
+
+                        if (emptyFrom >= 0 && (value != MineMap::EMPTY || j == segmentTo))
+                        {
+                            runs.push_back({ i, emptyFrom, value == MineMap::EMPTY ? j : j - 1 });
+                            emptyFrom = -1;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    std::size_t SparseMineMap::open_run(const int x, const int yFrom, const int yTo)
+    {
+        auto& runs = m_openRuns[x];
+        auto mergedFrom = yFrom;
+        auto mergedTo = yTo;
+        std::size_t alreadyOpen = 0;
+
+        // Find the first run which overlaps or touches [yFrom, yTo].
+        auto it = runs.upper_bound(yFrom);
+        if (it != runs.begin() && std::prev(it)->second >= yFrom - 1)
+        {
+            --it;
+        }
+
+        // Merge all such runs into one.
+        while (it != runs.end() && it->first <= yTo + 1)
+        {
+            const auto overlap = std::min(it->second, yTo) - std::max(it->first, yFrom) + 1;
+            alreadyOpen += std::max(overlap, 0);
+
+            mergedFrom = std::min(mergedFrom, it->first);
+            mergedTo = std::max(mergedTo, it->second);
+            it = runs.erase(it);
+        }
+
+        runs[mergedFrom] = mergedTo;
+
+        return static_cast<std::size_t>(yTo - yFrom + 1) - alreadyOpen;
+    }
+
+    std::vector<std::pair<int, int>> SparseMineMap::get_closed_runs(const int x, const int yFrom, const int yTo) const
+    {
+        auto closedRuns = std::vector<std::pair<int, int>>();
+
+        const auto column = m_openRuns.find(x);
+        auto flag = m_flags.lower_bound(Position(x, yFrom));
+
+        auto y = yFrom;
+        while (y <= yTo)
+        {
+            // Skip the open run containing this grid, and find where the next one starts.
+            auto nextOpen = yTo + 1;
+            if (column != m_openRuns.end())
+            {
+                const auto it = column->second.upper_bound(y);
+                if (it != column->second.begin() && std::prev(it)->second >= y)
+                {
+                    y = std::prev(it)->second + 1;
+                    continue;
+                }
+
+                if (it != column->second.end())
+                {
+                    nextOpen = std::min(nextOpen, it->first);
+                }
+            }
+
+            // Skip a flag on this grid, and find the next one.
+            while (flag != m_flags.end() && *flag < Position(x, y))
+            {
+                ++flag;
+            }
+
+            if (flag != m_flags.end() && *flag == Position(x, y))
+            {
+                y++;
+                continue;
+            }
+
+            const auto nextFlag = flag != m_flags.end() && flag->first == x ? flag->second : yTo + 1;
+            const auto runTo = std::min({ yTo, nextOpen - 1, nextFlag - 1 });
+
+            closedRuns.push_back({ y, runTo });
+            y = runTo + 1;
+        }
+
+        return closedRuns;
+    }
+
+    std::vector<MineMapValue> SparseMineMap::get_values(const int x, const int yFrom, const int yTo) const
+    {
+        auto values = std::vector<MineMapValue>(yTo - yFrom + 1, MineMap::EMPTY);
+
+        // Add one to the grids of the run around each mine near it.
+        for (auto i = x - 1; i <= x + 1; i++)
+        {
+            const auto last = Position(i, yTo + 1);
+            for (auto it = m_mines.lower_bound(Position(i, yFrom - 1)); it != m_mines.end() && *it <= last; ++it)
+            {
+                for (auto j = std::max(it->second - 1, yFrom); j <= std::min(it->second + 1, yTo); j++)
+                {
+                    if (i != x || j != it->second)
+                    {
+                        values[j - yFrom]++;
+                    }
+                }
+            }
+        }
+
+        for (auto it = m_mines.lower_bound(Position(x, yFrom)); it != m_mines.end() && *it <= Position(x, yTo); ++it)
+        {
+            values[it->second - yFrom] = MineMap::MINE;
+        }
+
+        return values;
+    }
+
+    void SparseMineMap::raise_event(const MineMapEvent& event) const
+    {
+        if (m_eventSink)
+        {
+            m_eventSink(event);
+        }
+    }
+
+    bool SparseMineMap::is_open(const Position pos) const noexcept
+    {
+        const auto column = m_openRuns.find(pos.first);
+        if (column == m_openRuns.end())
+        {
+            return false;
+        }
+
+        // The last run starting at or before the position.
+        auto it = column->second.upper_bound(pos.second);
+        if (it == column->second.begin())
+        {
+            return false;
+        }
+
+        return std::prev(it)->second >= pos.second;
+    }
+
+    bool SparseMineMap::is_closed(const Position pos) const noexcept
+    {
+        return !is_open(pos) && !m_flags.contains(pos);
+    }
+
+    MineMapValue SparseMineMap::get_value(const Position pos) const noexcept
+    {
+        return m_mines.contains(pos) ? MineMap::MINE : get_adjacent_count(m_mines, pos);
+    }
+
+    int SparseMineMap::get_adjacent_count(const std::set<Position>& positions, const Position pos) const noexcept
+    {
+        auto count = 0;
+
+        for (auto x = pos.first - 1; x <= pos.first + 1; x++)
+        {
+            // The positions are sorted by X and then Y, so each column is a contiguous range.
+            const auto last = Position(x, pos.second + 1);
+            for (auto it = positions.lower_bound(Position(x, pos.second - 1)); it != positions.end() && *it <= last; ++it)
+            {
+                if (*it != pos)
+                {
+                    count++;
+                }
+            }
+        }
+
+        return count;
+    }
+
+    bool SparseMineMap::is_valid_position(const Position pos) const noexcept
+    {
+        return pos.first >= 0 && pos.first < m_width && pos.second >= 0 && pos.second < m_height;
+    }
+}
@@ -0,0 +1,241 @@
+#pragma once
+#include <map>
+#include <set>
+#include <vector>
+
+#include "GameStatus.h"
+#include "GridStatus.h"
+#include "MineMap.h"
+
+namespace Minesweeper::MineMap
+{
+    /// <summary>
+    /// The game state for very large maps with few mines.
+    /// Memory scales with the mines, the flags and the boundary of the opened area instead of the map size.
+    /// Behaves exactly like <see cref="MineMap"/>.
+    /// </summary>
+    class SparseMineMap
+    {
+    public:
+        /// <summary>
+        /// Initialises a new instance of the <see cref="SparseMineMap"/> class.
+        /// </summary>
+        /// <param name="width">The width of the map.</param>
+        /// <param name="height">The height of the map.</param>
+        /// <param name="mineCount">The count of mines.</param>
+        SparseMineMap(const std::size_t width, const std::size_t height, const int mineCount);
+
+        /// <summary>
+        /// Initialises a new instance of the <see cref="SparseMineMap"/> class with the given mines.
+        /// If the first click hits a mine, the mine is moved to a random grid without one.
+        /// </summary>
+        /// <param name="width">The width of the map.</param>
+        /// <param name="height">The height of the map.</param>
+        /// <param name="mines">The positions of the mines.</param>
+        SparseMineMap(const std::size_t width, const std::size_t height, const std::vector<Position>& mines);
+
+        /// <summary>
+        /// Gets mine map. The whole map is materialised, so this is meant for small maps only.
+        /// </summary>
+        /// <returns>The mine map.</returns>
+        const std::vector<std::vector<MineMapValue>> get_minemap() const;
+
+        /// <summary>
+        /// Gets grid statuses. The whole map is materialised, so this is meant for small maps only.
+        /// </summary>
+        /// <returns>The grid statuses.</returns>
+        const std::vector<std::vector<GridStatus>> get_grid_status() const;
+
+        /// <summary>
+        /// Clicks a grid.
+        /// </summary>
+        /// <param name="pos">The position where to click.</param>
+        void click(const Position pos);
+
+        /// <summary>
+        /// Chords a grid.
+        /// </summary>
+        /// <param name="pos">The position where to chord.</param>
+        void chord(const Position pos);
+
+        /// <summary>
+        /// Flags a grid.
+        /// </summary>
+        /// <param name="pos">The position where to flag.</param>
+        void flag(const Position pos);
+
+        /// <summary>
+        /// Gets the game status.
+        /// </summary>
+        /// <returns>The game status.</returns>
+        const GameStatus get_game_status() const noexcept;
+
+        /// <summary>
+        /// Checks if the player wins.
+        /// </summary>
+        /// <returns>Whether the player wins.</returns>
+        bool is_winning() const noexcept;
+
+        /// <summary>
+        /// Sets the function receiving an event for every opened grid, toggled flag and the end of the game.
+        /// </summary>
+        /// <param name="sink">The event sink, or an empty function to stop receiving events.</param>
+        void set_event_sink(EventSink sink);
+    private:
+        /// <summary>
+        /// The positions of the mines.
+        /// </summary>
+        std::set<Position> m_mines;
+
+        /// <summary>
+        /// The positions of the flags.
+        /// </summary>
+        std::set<Position> m_flags;
+
+        /// <summary>
+        /// The opened grids, as runs of Y coordinates for each X coordinate.
+        /// Each run maps its first Y coordinate to its last one, both inclusive.
+        /// </summary>
+        std::map<int, std::map<int, int>> m_openRuns;
+
+        /// <summary>
+        /// The map width.
+        /// </summary>
+        std::size_t m_width;
+
+        /// <summary>
+        /// The map height.
+        /// </summary>
+        std::size_t m_height;
+
+        /// <summary>
+        /// The number of mines.
+        /// </summary>
+        int m_mineCount;
+
+        /// <summary>
+        /// The game status.
+        /// </summary>
+        GameStatus m_gameStatus;
+
+        /// <summary>
+        /// The number of grids without mines.
+        /// </summary>
+        std::size_t m_safeGridCount;
+
+        /// <summary>
+        /// The number of opened grids without mines.
+        /// </summary>
+        std::size_t m_openSafeGridCount;
+
+        /// <summary>
+        /// Whether a grid with mine has been opened.
+        /// </summary>
+        bool m_isMineOpened;
+
+        /// <summary>
+        /// Whether the mines have been placed.
+        /// </summary>
+        bool m_areMinesPlaced;
+
+        /// <summary>
+        /// The event sink.
+        /// </summary>
+        EventSink m_eventSink;
+
+        /// <summary>
+        /// Places the mines.
+        /// </summary>
+        /// <param name="clickedPos">The position that the player clicks.</param>
+        void generate_mines(const Position clickedPos);
+
+        /// <summary>
+        /// Moves a mine to a random grid without one. If every grid has a mine, the mine is removed instead.
+        /// </summary>
+        /// <param name="pos">The position of the mine.</param>
+        void move_mine(const Position pos);
+
+        /// <summary>
+        /// Opens the seed grids in order, and then the adjacent grids of the empty ones.
+        /// Stops opening seeds once a mine is opened.
+        /// </summary>
+        /// <param name="seeds">The positions to open.</param>
+        void open_grids(const std::vector<Position>& seeds);
+
+        /// <summary>
+        /// Opens the adjacent grids of the empty grids in the frontier, one run of empty grids at a time.
+        /// The closed grids beside a run are opened a whole segment at a time.
+        /// </summary>
+        /// <param name="frontier">The opened empty grids.</param>
+        void fill(std::vector<Position> frontier);
+
+        /// <summary>
+        /// Opens a run of grids in one column, without raising events. Grids already open are left as they are.
+        /// </summary>
+        /// <param name="x">The X coordinate.</param>
+        /// <param name="yFrom">The first Y coordinate, inclusive.</param>
+        /// <param name="yTo">The last Y coordinate, inclusive.</param>
+        /// <returns>The number of grids newly opened.</returns>
+        std::size_t open_run(const int x, const int yFrom, const int yTo);
+
+        /// <summary>
+        /// Finds the maximal runs of closed grids in part of a column, stepping over the open runs and the flags.
+        /// </summary>
+        /// <param name="x">The X coordinate.</param>
+        /// <param name="yFrom">The first Y coordinate, inclusive.</param>
+        /// <param name="yTo">The last Y coordinate, inclusive.</param>
+        /// <returns>The first and last Y coordinates of each run, both inclusive.</returns>
+        std::vector<std::pair<int, int>> get_closed_runs(const int x, const int yFrom, const int yTo) const;
+
+        /// <summary>
+        /// Gets the values of a run of grids in one column, visiting each nearby mine once.
+        /// </summary>
+        /// <param name="x">The X coordinate.</param>
+        /// <param name="yFrom">The first Y coordinate, inclusive.</param>
+        /// <param name="yTo">The last Y coordinate, inclusive.</param>
+        /// <returns>The values, starting with the one at the first Y coordinate.</returns>
+        std::vector<MineMapValue> get_values(const int x, const int yFrom, const int yTo) const;
+
+        /// <summary>
+        /// Sends an event to the event sink, if there is one.
+        /// </summary>
+        /// <param name="event">The event.</param>
+        void raise_event(const MineMapEvent& event) const;
+
+        /// <summary>
+        /// Checks if a grid is open.
+        /// </summary>
+        /// <param name="pos">The position.</param>
+        /// <returns>Whether the grid is open.</returns>
+        bool is_open(const Position pos) const noexcept;
+
+        /// <summary>
+        /// Checks if a grid is closed and not flagged.
+        /// </summary>
+        /// <param name="pos">The position.</param>
+        /// <returns>Whether the grid is closed.</returns>
+        bool is_closed(const Position pos) const noexcept;
+
+        /// <summary>
+        /// Gets the value of a grid.
+        /// </summary>
+        /// <param name="pos">The position.</param>
+        /// <returns>The value of the grid.</returns>
+        MineMapValue get_value(const Position pos) const noexcept;
+
+        /// <summary>
+        /// Counts the positions of a set adjacent to a grid.
+        /// </summary>
+        /// <param name="positions">The set of positions.</param>
+        /// <param name="pos">The position.</param>
+        /// <returns>The number of adjacent positions in the set.</returns>
+        int get_adjacent_count(const std::set<Position>& positions, const Position pos) const noexcept;
+
+        /// <summary>
+        /// Checks if the position is valid.
+        /// </summary>
+        /// <param name="pos">The position.</param>
+        /// <returns>Whether the position is valid.</returns>
+        bool is_valid_position(const Position pos) const noexcept;
+    };
+}
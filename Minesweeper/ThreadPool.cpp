@@ -0,0 +1,130 @@
+#include <algorithm>
+
+#include "ThreadPool.h"
+
+namespace Minesweeper::Utils
+{
+    ThreadPool::ThreadPool(const unsigned int workerCount)
+        : m_task(nullptr), m_taskWorkerCount(0), m_runningCount(0), m_generation(0), m_isStopping(false)
+    {
+        for (auto i = 0u; i < workerCount; i++)
+        {
+            m_workers.emplace_back(&ThreadPool::run_worker, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            auto lock = std::lock_guard(m_mutex);
+            m_isStopping = true;
+        }
+
+        m_taskCondition.notify_all();
+
+        for (auto& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    unsigned int ThreadPool::get_worker_count() const noexcept
+    {
+        return static_cast<unsigned int>(m_workers.size());
+    }
+
+    void ThreadPool::run(const std::function<void()>& task, const unsigned int threadCount)
+    {
+        auto runLock = std::lock_guard(m_runMutex);
+
+        {
+            auto lock = std::lock_guard(m_mutex);
+            m_task = &task;
+            m_taskWorkerCount = std::min(std::max(threadCount, 1u) - 1, get_worker_count());
+            m_runningCount = m_taskWorkerCount;
+            m_exception = nullptr;
+            m_generation++;
+        }
+
+        m_taskCondition.notify_all();
+
+        auto exception = std::exception_ptr();
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+
+        auto lock = std::unique_lock(m_mutex);
+        m_doneCondition.wait(lock, [this] { return m_runningCount == 0; });
+        m_task = nullptr;
+
+        if (!exception)
+        {
+            exception = m_exception;
+        }
+
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    ThreadPool& ThreadPool::get_shared()
+    {
+        static auto pool = ThreadPool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+        return pool;
+    }
+
+    void ThreadPool::run_worker(const unsigned int index)
+    {
+        auto generation = std::size_t(0);
+        auto lock = std::unique_lock(m_mutex);
+
+        for (;;)
+        {
+            m_taskCondition.wait(lock, [&] { return m_isStopping || m_generation != generation; });
+
+            if (m_isStopping)
+            {
+                return;
+            }
+
+            generation = m_generation;
+
+            // Workers beyond the requested thread count sit this task out.
+            if (index >= m_taskWorkerCount)
+            {
+                continue;
+            }
+
+            const auto& task = *m_task;
+            lock.unlock();
+
+            auto exception = std::exception_ptr();
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+            }
+
+            lock.lock();
+
+            if (exception && !m_exception)
+            {
+                m_exception = exception;
+            }
+
+            if (--m_runningCount == 0)
+            {
+                m_doneCondition.notify_one();
+            }
+        }
+    }
+}
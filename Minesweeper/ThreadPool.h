@@ -0,0 +1,114 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Minesweeper::Utils
+{
+    /// <summary>
+    /// Worker threads which are started once and run the same task together on request,
+    /// so that parallel work does not pay for starting threads every time.
+    /// </summary>
+    class ThreadPool
+    {
+    public:
+        /// <summary>
+        /// Initialises a new instance of the <see cref="ThreadPool"/> class.
+        /// </summary>
+        /// <param name="workerCount">The number of worker threads.</param>
+        explicit ThreadPool(const unsigned int workerCount);
+
+        /// <summary>
+        /// Stops the worker threads.
+        /// </summary>
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /// <summary>
+        /// Gets the number of worker threads.
+        /// </summary>
+        /// <returns>The number of worker threads.</returns>
+        unsigned int get_worker_count() const noexcept;
+
+        /// <summary>
+        /// Runs a task on the calling thread and on worker threads at the same time, and waits until every run returns.
+        /// Calls from different threads run one after another. The first exception thrown by a run is rethrown.
+        /// </summary>
+        /// <param name="task">The task.</param>
+        /// <param name="threadCount">The number of threads running the task, including the calling one. Capped at the number of workers plus one.</param>
+        void run(const std::function<void()>& task, const unsigned int threadCount);
+
+        /// <summary>
+        /// Gets the pool shared by the program, with a worker for each hardware thread besides the calling one.
+        /// </summary>
+        /// <returns>The thread pool.</returns>
+        static ThreadPool& get_shared();
+    private:
+        /// <summary>
+        /// The task being run, or null.
+        /// </summary>
+        const std::function<void()>* m_task;
+
+        /// <summary>
+        /// The number of workers joining the task being run.
+        /// </summary>
+        unsigned int m_taskWorkerCount;
+
+        /// <summary>
+        /// The number of workers still running the task.
+        /// </summary>
+        unsigned int m_runningCount;
+
+        /// <summary>
+        /// Increased for every task, so that the workers can tell a new task from a spurious wake-up.
+        /// </summary>
+        std::size_t m_generation;
+
+        /// <summary>
+        /// The first exception thrown by a worker running the task.
+        /// </summary>
+        std::exception_ptr m_exception;
+
+        /// <summary>
+        /// Whether the worker threads are stopping.
+        /// </summary>
+        bool m_isStopping;
+
+        /// <summary>
+        /// Makes concurrent calls to <see cref="run"/> wait for each other.
+        /// </summary>
+        std::mutex m_runMutex;
+
+        /// <summary>
+        /// The mutex guarding the task state.
+        /// </summary>
+        std::mutex m_mutex;
+
+        /// <summary>
+        /// Signals the workers when a task is started or the pool is stopping.
+        /// </summary>
+        std::condition_variable m_taskCondition;
+
+        /// <summary>
+        /// Signals the calling thread when the last worker finishes the task.
+        /// </summary>
+        std::condition_variable m_doneCondition;
+
+        /// <summary>
+        /// The worker threads.
+        /// </summary>
+        std::vector<std::thread> m_workers;
+
+        /// <summary>
+        /// Runs the tasks which this worker joins, until the pool is stopping.
+        /// </summary>
+        /// <param name="index">The index of the worker.</param>
+        void run_worker(const unsigned int index);
+    };
+}